@@ -0,0 +1,177 @@
+#include <common/realtime.h>
+#include <common/thread_pool.h>
+#include <common/types_asio.h>
+#include <transport/socket_options.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// Round trip time of modbus tcp sized request over loopback, server and client run on own context.
+// Compare blocking reactor and busy poll of io threads, cpu time shows cost of busy poll:
+// bench_busy_poll [SO_BUSY_POLL us]
+
+namespace {
+
+constexpr size_t requestsCount = 20000;
+constexpr size_t frameSize = 12;
+
+using Frame = std::array<uint8_t, frameSize>;
+
+class EchoServer {
+public:
+  explicit EchoServer(const modbus_gateway::ContextPtr &context)
+      : acceptor_(*context, modbus_gateway::TcpEndpoint(asio::ip::address_v4::loopback(), 0)),
+        socket_(*context),
+        frame_() {}
+
+  modbus_gateway::TcpEndpoint GetEndpoint() const {
+    return acceptor_.local_endpoint();
+  }
+
+  void Start(const modbus_gateway::SocketOptions &socketOptions) {
+    acceptor_.async_accept(socket_, [this, socketOptions](const asio::error_code &ec) {
+      if (ec) {
+        return;
+      }
+      socket_.set_option(asio::ip::tcp::no_delay(true));
+      modbus_gateway::SetOptions(socket_, socketOptions);
+      Read();
+    });
+  }
+
+private:
+  void Read() {
+    asio::async_read(socket_, asio::buffer(frame_), [this](const asio::error_code &ec, size_t) {
+      if (ec) {
+        return;
+      }
+      asio::async_write(socket_, asio::buffer(frame_), [this](const asio::error_code &ec, size_t) {
+        if (ec) {
+          return;
+        }
+        Read();
+      });
+    });
+  }
+
+  modbus_gateway::TcpAcceptor acceptor_;
+  asio::ip::tcp::socket socket_;
+  Frame frame_;
+};
+
+class Client {
+public:
+  Client(const modbus_gateway::ContextPtr &context, std::vector<double> &samples)
+      : context_(context), socket_(*context), frame_(), samples_(samples), begin_() {}
+
+  void Start(const modbus_gateway::TcpEndpoint &endpoint, const modbus_gateway::SocketOptions &socketOptions) {
+    socket_.async_connect(endpoint, [this, socketOptions](const asio::error_code &ec) {
+      if (ec) {
+        context_->stop();
+        return;
+      }
+      socket_.set_option(asio::ip::tcp::no_delay(true));
+      modbus_gateway::SetOptions(socket_, socketOptions);
+      Send();
+    });
+  }
+
+private:
+  void Send() {
+    begin_ = std::chrono::steady_clock::now();
+    asio::async_write(socket_, asio::buffer(frame_), [this](const asio::error_code &ec, size_t) {
+      if (ec) {
+        context_->stop();
+        return;
+      }
+      asio::async_read(socket_, asio::buffer(frame_), [this](const asio::error_code &ec, size_t) {
+        if (ec) {
+          context_->stop();
+          return;
+        }
+        const auto rtt = std::chrono::steady_clock::now() - begin_;
+        samples_.push_back(std::chrono::duration<double, std::micro>(rtt).count());
+        if (samples_.size() == requestsCount) {
+          context_->stop();
+          return;
+        }
+        Send();
+      });
+    });
+  }
+
+  modbus_gateway::ContextPtr context_;
+  asio::ip::tcp::socket socket_;
+  Frame frame_;
+  std::vector<double> &samples_;
+  std::chrono::steady_clock::time_point begin_;
+};
+
+void Run(bool busyPoll, const modbus_gateway::SocketOptions &socketOptions) {
+  auto serverContext = std::make_shared<modbus_gateway::ContextPtr::element_type>(1);
+  auto clientContext = std::make_shared<modbus_gateway::ContextPtr::element_type>(1);
+  auto serverWork = asio::executor_work_guard(serverContext->get_executor());
+
+  std::vector<double> samples;
+  samples.reserve(requestsCount);
+  EchoServer server(serverContext);
+  Client client(clientContext, samples);
+  server.Start(socketOptions);
+  client.Start(server.GetEndpoint(), socketOptions);
+
+  modbus_gateway::ThreadOptions threadOptions;
+  threadOptions.busyPoll = busyPoll;
+  modbus_gateway::ThreadPool serverPool(serverContext, 1);
+  modbus_gateway::ThreadPool clientPool(clientContext, 1);
+  serverPool.SetThreadOptions(threadOptions);
+  clientPool.SetThreadOptions(threadOptions);
+
+  const std::clock_t cpuBegin = std::clock();
+  const auto begin = std::chrono::steady_clock::now();
+  serverPool.Run();
+  clientPool.Run();
+  clientPool.Join();
+  const auto end = std::chrono::steady_clock::now();
+  const std::clock_t cpuEnd = std::clock();
+  serverPool.Stop();
+  serverPool.Join();
+
+  if (samples.empty()) {
+    std::cout << "no samples\n";
+    return;
+  }
+  std::sort(samples.begin(), samples.end());
+  const std::chrono::duration<double> wall = end - begin;
+  const double cpu = static_cast<double>(cpuEnd - cpuBegin) / CLOCKS_PER_SEC;
+  std::cout << std::setw(10) << (busyPoll ? "busy poll" : "blocking")
+            << std::fixed << std::setprecision(1)
+            << std::setw(10) << samples[samples.size() / 2]
+            << std::setw(10) << samples[samples.size() * 99 / 100]
+            << std::setw(10) << samples.back()
+            << std::setw(12) << std::setprecision(0) << 100.0 * cpu / wall.count() << '\n';
+}
+
+}// namespace
+
+int main(int argc, char **argv) {
+  modbus_gateway::SocketOptions socketOptions;
+  if (argc > 1) {
+    socketOptions.busyPoll = static_cast<uint32_t>(std::atoi(argv[1]));
+  }
+  std::cout << "requests " << requestsCount << ", frame " << frameSize << " bytes, SO_BUSY_POLL "
+            << socketOptions.busyPoll.value_or(0) << "us\n";
+  std::cout << std::setw(10) << "mode"
+            << std::setw(10) << "p50, us"
+            << std::setw(10) << "p99, us"
+            << std::setw(10) << "max, us"
+            << std::setw(12) << "cpu, %" << '\n';
+  Run(false, socketOptions);
+  Run(true, socketOptions);
+  return EXIT_SUCCESS;
+}
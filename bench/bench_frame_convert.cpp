@@ -0,0 +1,85 @@
+#include <transport/frame_converter.h>
+
+#include <modbus/modbus_buffer.h>
+#include <modbus/modbus_buffer_wrapper.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// Request passes gateway with conversion between frame types of slave and master.
+// Compare unconditional ConvertTo and Update with ConvertFrame, which keeps frame of same type as is.
+// Pairs of different types show cost of pdu move and checksum, it is same for both columns.
+
+namespace {
+
+constexpr size_t iterations = 1000000;
+
+// read holding registers, unit 1, address 0, count 1
+const modbus::AduBuffer tcpFrame = {0x0, 0x1, 0x0, 0x0, 0x0, 0x6, 0x1, 0x3, 0x0, 0x0, 0x0, 0x1};
+
+size_t sink = 0;
+
+modbus::ModbusBuffer MakeFrame(modbus::FrameType frameType) {
+  modbus::ModbusBuffer modbusBuffer(modbus::FrameType::TCP);
+  std::copy(tcpFrame.begin(), tcpFrame.end(), modbusBuffer.begin());
+  modbusBuffer.SetAduSize(tcpFrame.size());
+  modbus_gateway::ConvertFrame(modbusBuffer, frameType);
+  return modbusBuffer;
+}
+
+std::string ToString(modbus::FrameType frameType) {
+  switch (frameType) {
+  case modbus::FrameType::TCP: return "tcp";
+  case modbus::FrameType::RTU: return "rtu";
+  case modbus::FrameType::ASCII: return "ascii";
+  default: return "unknown";
+  }
+}
+
+template<typename Convert>
+double Run(const modbus::ModbusBuffer &frame, modbus::FrameType frameType, Convert convert) {
+  modbus::ModbusBuffer modbusBuffer = frame;
+  const auto begin = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    modbusBuffer = frame;
+    convert(modbusBuffer, frameType);
+    sink += modbusBuffer.GetAduSize();
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  const std::chrono::duration<double> seconds = end - begin;
+  return static_cast<double>(iterations) / seconds.count();
+}
+
+}// namespace
+
+int main() {
+  static const modbus::FrameType frameTypes[] = {modbus::FrameType::TCP, modbus::FrameType::RTU, modbus::FrameType::ASCII};
+
+  std::cout << "iterations " << iterations << '\n';
+  std::cout << std::setw(15) << "conversion"
+            << std::setw(25) << "convert+update, conv/s"
+            << std::setw(25) << "ConvertFrame, conv/s" << '\n';
+  for (const auto from: frameTypes) {
+    const auto frame = MakeFrame(from);
+    for (const auto to: frameTypes) {
+      const double updateRate = Run(frame, to, [](modbus::ModbusBuffer &modbusBuffer, modbus::FrameType frameType) {
+        modbusBuffer.ConvertTo(frameType);
+        auto wrapper = modbus::MakeModbusBufferWrapper(modbusBuffer);
+        wrapper->Update();
+      });
+      const double convertRate = Run(frame, to, [](modbus::ModbusBuffer &modbusBuffer, modbus::FrameType frameType) {
+        modbus_gateway::ConvertFrame(modbusBuffer, frameType);
+      });
+      std::cout << std::setw(15) << (ToString(from) + "->" + ToString(to))
+                << std::setw(25) << std::fixed << std::setprecision(0) << updateRate
+                << std::setw(25) << std::fixed << std::setprecision(0) << convertRate << '\n';
+    }
+  }
+  std::cout << "checksum " << sink << '\n';
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,132 @@
+#include <common/realtime.h>
+#include <common/thread_pool.h>
+#include <common/types_asio.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Measure lateness of timer handler, it is same path as response waiting in ModbusRtuMaster.
+// Run on loaded box to compare default scheduling and realtime settings:
+// bench_jitter [other|fifo|rr] [priority] [cpu] [load threads]
+
+namespace {
+
+constexpr size_t samplesCount = 20000;
+constexpr std::chrono::microseconds period(500);
+
+class JitterTimer {
+public:
+  JitterTimer(const modbus_gateway::ContextPtr &context, std::vector<double> &samples)
+      : context_(context), timer_(*context), samples_(samples), expected_() {}
+
+  void Start() {
+    expected_ = std::chrono::steady_clock::now() + period;
+    Wait();
+  }
+
+private:
+  void Wait() {
+    timer_.expires_at(expected_);
+    timer_.async_wait([this](const asio::error_code &ec) {
+      if (ec) {
+        return;
+      }
+      const auto lateness = std::chrono::steady_clock::now() - expected_;
+      samples_.push_back(std::chrono::duration<double, std::micro>(lateness).count());
+      if (samples_.size() == samplesCount) {
+        context_->stop();
+        return;
+      }
+      expected_ += period;
+      Wait();
+    });
+  }
+
+  modbus_gateway::ContextPtr context_;
+  asio::steady_timer timer_;
+  std::vector<double> &samples_;
+  std::chrono::steady_clock::time_point expected_;
+};
+
+modbus_gateway::SchedPolicy ParsePolicy(const std::string &policy) {
+  if ("fifo" == policy) {
+    return modbus_gateway::SchedPolicy::Fifo;
+  }
+  if ("rr" == policy) {
+    return modbus_gateway::SchedPolicy::RoundRobin;
+  }
+  return modbus_gateway::SchedPolicy::Other;
+}
+
+double Percentile(const std::vector<double> &sorted, double percent) {
+  const auto index = static_cast<size_t>(percent / 100.0 * static_cast<double>(sorted.size() - 1));
+  return sorted[index];
+}
+
+}// namespace
+
+int main(int argc, char **argv) {
+  modbus_gateway::ThreadOptions threadOptions;
+  threadOptions.policy = argc > 1 ? ParsePolicy(argv[1]) : modbus_gateway::SchedPolicy::Other;
+  threadOptions.priority = argc > 2 ? std::atoi(argv[2]) : 0;
+  if (argc > 3) {
+    threadOptions.cpus = {static_cast<size_t>(std::atoi(argv[3]))};
+  }
+  const size_t loadThreads = argc > 4 ? static_cast<size_t>(std::atoi(argv[4])) : modbus_gateway::GetCpuCount();
+  threadOptions.prefaultStack = 256 * 1024;
+
+  if (modbus_gateway::SchedPolicy::Other != threadOptions.policy) {
+    modbus_gateway::LockMemory();
+  }
+
+  std::atomic<bool> loadRun(true);
+  std::vector<std::thread> load;
+  load.reserve(loadThreads);
+  for (size_t i = 0; i < loadThreads; ++i) {
+    load.emplace_back([&loadRun]() {
+      volatile size_t counter = 0;
+      while (loadRun.load(std::memory_order_relaxed)) {
+        counter = counter + 1;
+      }
+    });
+  }
+
+  auto context = std::make_shared<modbus_gateway::ContextPtr::element_type>(1);
+  std::vector<double> samples;
+  samples.reserve(samplesCount);
+  JitterTimer timer(context, samples);
+  timer.Start();
+
+  modbus_gateway::ThreadPool threadPool(context, 1);
+  threadPool.SetThreadOptions(threadOptions);
+  threadPool.Run();
+  threadPool.Join();
+
+  loadRun = false;
+  for (auto &thread : load) {
+    thread.join();
+  }
+
+  std::sort(samples.begin(), samples.end());
+  double sum = 0;
+  for (const double sample : samples) {
+    sum += sample;
+  }
+  std::cout << "period " << period.count() << "us, samples " << samples.size()
+            << ", load threads " << loadThreads << '\n';
+  std::cout << std::fixed << std::setprecision(1)
+            << "lateness, us: min " << samples.front()
+            << ", avg " << sum / static_cast<double>(samples.size())
+            << ", p50 " << Percentile(samples, 50)
+            << ", p99 " << Percentile(samples, 99)
+            << ", p99.9 " << Percentile(samples, 99.9)
+            << ", max " << samples.back() << '\n';
+  return EXIT_SUCCESS;
+}
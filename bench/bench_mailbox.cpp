@@ -0,0 +1,150 @@
+#include <common/mpsc_mailbox.h>
+#include <common/thread_pool.h>
+#include <common/types_asio.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Many tcp connections route requests to one rtu master. Compare delivery by asio::dispatch to
+// master strand per message (strand queue under mutex) and by lock-free mailbox with wake of
+// master strand only when mailbox becomes non-empty.
+
+namespace {
+
+constexpr size_t messagesPerProducer = 100000;
+constexpr size_t mailboxCapacity = 1024;
+
+using Strand = asio::strand<modbus_gateway::ContextPtr::element_type::executor_type>;
+
+struct Message {
+  size_t value = 0;
+};
+
+using MessagePtr = std::shared_ptr<Message>;
+
+class StrandMaster {
+public:
+  explicit StrandMaster(const modbus_gateway::ContextPtr &context)
+      : strand_(asio::make_strand(*context)), received_(0), sum_(0) {}
+
+  bool Receive(const MessagePtr &message) {
+    asio::dispatch(strand_, [this, message]() {
+      sum_ += message->value;
+      received_.fetch_add(1, std::memory_order_release);
+    });
+    return true;
+  }
+
+  size_t Received() const {
+    return received_.load(std::memory_order_acquire);
+  }
+
+private:
+  Strand strand_;
+  std::atomic<size_t> received_;
+  size_t sum_;
+};
+
+class MailboxMaster {
+public:
+  explicit MailboxMaster(const modbus_gateway::ContextPtr &context)
+      : strand_(asio::make_strand(*context)), mailbox_(mailboxCapacity), received_(0), sum_(0) {}
+
+  bool Receive(const MessagePtr &message) {
+    bool wake = false;
+    if (!mailbox_.Push(message, wake)) {
+      return false;
+    }
+    if (wake) {
+      asio::dispatch(strand_, [this]() {
+        Process();
+      });
+    }
+    return true;
+  }
+
+  size_t Received() const {
+    return received_.load(std::memory_order_acquire);
+  }
+
+private:
+  void Process() {
+    MessagePtr message;
+    bool more = true;
+    while (more && mailbox_.Pop(message)) {
+      sum_ += message->value;
+      received_.fetch_add(1, std::memory_order_release);
+      more = mailbox_.Release();
+    }
+    if (more) {
+      asio::post(strand_, [this]() {
+        Process();
+      });
+    }
+  }
+
+  Strand strand_;
+  modbus_gateway::MpscMailbox<MessagePtr> mailbox_;
+  std::atomic<size_t> received_;
+  size_t sum_;
+};
+
+template<typename Master>
+double Run(size_t producers) {
+  // one more thread for master, producers occupy own threads
+  const size_t threads = producers + 1;
+  auto context = std::make_shared<modbus_gateway::ContextPtr::element_type>(static_cast<int>(threads));
+  auto work = asio::executor_work_guard(context->get_executor());
+  Master master(context);
+  modbus_gateway::ThreadPool threadPool(context, threads);
+  threadPool.Run();
+
+  const size_t total = producers * messagesPerProducer;
+  const auto begin = std::chrono::steady_clock::now();
+  // producers run as handlers of same pool, like connection read handlers
+  for (size_t producer = 0; producer < producers; ++producer) {
+    asio::post(*context, [&master]() {
+      auto message = std::make_shared<Message>();
+      message->value = 1;
+      for (size_t i = 0; i < messagesPerProducer; ++i) {
+        while (!master.Receive(message)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  while (master.Received() < total) {
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  work.reset();
+  threadPool.Stop();
+  threadPool.Join();
+
+  const std::chrono::duration<double> seconds = end - begin;
+  return static_cast<double>(total) / seconds.count();
+}
+
+}// namespace
+
+int main() {
+  std::cout << "messages per producer " << messagesPerProducer << ", mailbox capacity " << mailboxCapacity << '\n';
+  std::cout << std::setw(10) << "producers"
+            << std::setw(20) << "dispatch, msg/s"
+            << std::setw(20) << "mailbox, msg/s" << '\n';
+  for (const size_t producers : {1, 2, 4, 8, 16}) {
+    const double strandRate = Run<StrandMaster>(producers);
+    const double mailboxRate = Run<MailboxMaster>(producers);
+    std::cout << std::setw(10) << producers
+              << std::setw(20) << std::fixed << std::setprecision(0) << strandRate
+              << std::setw(20) << std::fixed << std::setprecision(0) << mailboxRate << '\n';
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,58 @@
+#include <common/types_modbus.h>
+#include <message/modbus_message.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+// One request-response round trip creates two buffers and two messages.
+// Compare make_shared with per thread pools.
+
+namespace {
+
+constexpr size_t roundTrips = 1000000;
+
+size_t sink = 0;
+
+template<typename MakeBuffer, typename MakeMessage>
+double Run(MakeBuffer makeBuffer, MakeMessage makeMessage) {
+  const auto begin = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < roundTrips; ++i) {
+    const modbus_gateway::ModbusMessageInfo info(1, static_cast<modbus::TransactionId>(i));
+    auto request = makeMessage(info, makeBuffer(modbus::FrameType::TCP));
+    auto response = makeMessage(request->GetModbusMessageInfo(), makeBuffer(modbus::FrameType::RTU));
+    request.reset();
+    sink += response->GetModbusMessageInfo().GetTransactionId();
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  const std::chrono::duration<double> seconds = end - begin;
+  return static_cast<double>(roundTrips * 2) / seconds.count();
+}
+
+}// namespace
+
+int main() {
+  const double heapRate = Run(
+      [](modbus::FrameType frameType) {
+        return std::make_shared<modbus::ModbusBuffer>(frameType);
+      },
+      [](const modbus_gateway::ModbusMessageInfo &info, const modbus_gateway::ModbusBufferPtr &buffer) {
+        return modbus_gateway::ModbusMessage::Create(info, buffer);
+      });
+  const double poolRate = Run(modbus_gateway::MakeModbusBuffer, modbus_gateway::MakeModbusMessage);
+
+  const auto bufferStats = modbus_gateway::GetModbusBufferPoolStats();
+  const auto messageStats = modbus_gateway::GetModbusMessagePoolStats();
+
+  std::cout << "round trips " << roundTrips << '\n';
+  std::cout << std::setw(20) << "make_shared, msg/s"
+            << std::setw(20) << "pool, msg/s" << '\n';
+  std::cout << std::setw(20) << std::fixed << std::setprecision(0) << heapRate
+            << std::setw(20) << std::fixed << std::setprecision(0) << poolRate << '\n';
+  std::cout << "buffer pool hits " << bufferStats.hits << ", misses " << bufferStats.misses << '\n';
+  std::cout << "message pool hits " << messageStats.hits << ", misses " << messageStats.misses << '\n';
+  std::cout << "checksum " << sink << '\n';
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,59 @@
+#include <message/client_disconnect_message.h>
+#include <message/message_kind.h>
+#include <message/modbus_message.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// Actor Receive selects message type on every message. Compare dynamic_pointer_cast with
+// exact type tag check and static_pointer_cast.
+
+namespace {
+
+constexpr size_t iterations = 10000000;
+
+size_t sink = 0;
+
+template<typename Cast>
+double Run(const std::vector<exchange::MessagePtr> &messages, Cast cast) {
+  const auto begin = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    const auto modbusMessage = cast(messages[i % messages.size()]);
+    if (modbusMessage) {
+      sink += modbusMessage->GetModbusMessageInfo().GetSourceId();
+    }
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  const std::chrono::duration<double> seconds = end - begin;
+  return static_cast<double>(iterations) / seconds.count();
+}
+
+}// namespace
+
+int main() {
+  // mostly modbus messages, sometimes disconnect
+  std::vector<exchange::MessagePtr> messages;
+  for (size_t i = 0; i < 15; ++i) {
+    messages.push_back(modbus_gateway::MakeModbusMessage(modbus_gateway::ModbusMessageInfo(1, 1), nullptr));
+  }
+  messages.push_back(modbus_gateway::ClientDisconnectMessage::Create(1));
+
+  const double dynamicRate = Run(messages, [](const exchange::MessagePtr &message) {
+    return std::dynamic_pointer_cast<modbus_gateway::ModbusMessage>(message);
+  });
+  const double kindRate = Run(messages, [](const exchange::MessagePtr &message) {
+    return modbus_gateway::MessageCast<modbus_gateway::ModbusMessage>(message);
+  });
+
+  std::cout << "iterations " << iterations << '\n';
+  std::cout << std::setw(30) << "dynamic_pointer_cast, msg/s"
+            << std::setw(25) << "message kind, msg/s" << '\n';
+  std::cout << std::setw(30) << std::fixed << std::setprecision(0) << dynamicRate
+            << std::setw(25) << std::fixed << std::setprecision(0) << kindRate << '\n';
+  std::cout << "checksum " << sink << '\n';
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,202 @@
+#include <common/types_asio.h>
+#include <transport/socket_options.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Client sends several modbus tcp sized polls back to back, server answers every poll with own write, as gateway
+// does when masters complete requests one by one. With Nagle algorithm next response waits for ack of previous one
+// and client delays ack, because it has nothing to send. Compare default socket, TCP_NODELAY and TCP_QUICKACK.
+// Two polls may pass without delay, ack of first response goes with second poll:
+// bench_nagle [polls in round, default 4]
+
+namespace {
+
+constexpr size_t rounds = 200;
+constexpr size_t frameSize = 12;
+
+using Frame = std::array<uint8_t, frameSize>;
+
+class EchoServer {
+public:
+  explicit EchoServer(asio::io_context &context)
+      : acceptor_(context, modbus_gateway::TcpEndpoint(asio::ip::address_v4::loopback(), 0)),
+        socket_(context),
+        frame_() {}
+
+  modbus_gateway::TcpEndpoint GetEndpoint() const {
+    return acceptor_.local_endpoint();
+  }
+
+  void Start(const modbus_gateway::SocketOptions &socketOptions) {
+    acceptor_.async_accept(socket_, [this, socketOptions](const asio::error_code &ec) {
+      if (ec) {
+        return;
+      }
+      socketOptions_ = socketOptions;
+      modbus_gateway::SetOptions(socket_, socketOptions_);
+      Read();
+    });
+  }
+
+private:
+  void Read() {
+    asio::async_read(socket_, asio::buffer(frame_), [this](const asio::error_code &ec, size_t) {
+      if (ec) {
+        return;
+      }
+      if (socketOptions_.quickAck.value_or(false)) {
+        modbus_gateway::RearmQuickAck(socket_);
+      }
+      asio::async_write(socket_, asio::buffer(frame_), [this](const asio::error_code &ec, size_t) {
+        if (ec) {
+          return;
+        }
+        Read();
+      });
+    });
+  }
+
+  modbus_gateway::TcpAcceptor acceptor_;
+  asio::ip::tcp::socket socket_;
+  modbus_gateway::SocketOptions socketOptions_;
+  Frame frame_;
+};
+
+class Client {
+public:
+  Client(asio::io_context &context, size_t polls, std::vector<double> &samples)
+      : context_(context), socket_(context), polls_(polls), sent_(0), frame_(), responses_(polls * frameSize),
+        samples_(samples), begin_() {}
+
+  void Start(const modbus_gateway::TcpEndpoint &endpoint, const modbus_gateway::SocketOptions &socketOptions) {
+    socket_.async_connect(endpoint, [this, socketOptions](const asio::error_code &ec) {
+      if (ec) {
+        context_.stop();
+        return;
+      }
+      socketOptions_ = socketOptions;
+      modbus_gateway::SetOptions(socket_, socketOptions_);
+      begin_ = std::chrono::steady_clock::now();
+      Send();
+    });
+  }
+
+private:
+  // every poll is own write, as independent requests of scada
+  void Send() {
+    asio::async_write(socket_, asio::buffer(frame_), [this](const asio::error_code &ec, size_t) {
+      if (ec) {
+        context_.stop();
+        return;
+      }
+      if (++sent_ < polls_) {
+        Send();
+        return;
+      }
+      Receive();
+    });
+  }
+
+  void Receive() {
+    asio::async_read(socket_, asio::buffer(responses_), [this](const asio::error_code &ec, size_t) {
+      if (ec) {
+        context_.stop();
+        return;
+      }
+      if (socketOptions_.quickAck.value_or(false)) {
+        modbus_gateway::RearmQuickAck(socket_);
+      }
+      const auto now = std::chrono::steady_clock::now();
+      samples_.push_back(std::chrono::duration<double, std::micro>(now - begin_).count());
+      if (samples_.size() == rounds) {
+        context_.stop();
+        return;
+      }
+      begin_ = now;
+      sent_ = 0;
+      Send();
+    });
+  }
+
+  asio::io_context &context_;
+  asio::ip::tcp::socket socket_;
+  modbus_gateway::SocketOptions socketOptions_;
+  size_t polls_;
+  size_t sent_;
+  Frame frame_;
+  std::vector<uint8_t> responses_;
+  std::vector<double> &samples_;
+  std::chrono::steady_clock::time_point begin_;
+};
+
+void Run(const char *name, size_t polls, const modbus_gateway::SocketOptions &socketOptions) {
+  asio::io_context serverContext(1);
+  asio::io_context clientContext(1);
+  auto serverWork = asio::make_work_guard(serverContext);
+
+  std::vector<double> samples;
+  samples.reserve(rounds);
+  EchoServer server(serverContext);
+  Client client(clientContext, polls, samples);
+  server.Start(socketOptions);
+  client.Start(server.GetEndpoint(), socketOptions);
+
+  std::thread serverThread([&serverContext]() {
+    serverContext.run();
+  });
+  const auto begin = std::chrono::steady_clock::now();
+  clientContext.run();
+  const auto end = std::chrono::steady_clock::now();
+  serverContext.stop();
+  serverThread.join();
+
+  if (samples.empty()) {
+    std::cout << "no samples\n";
+    return;
+  }
+  std::sort(samples.begin(), samples.end());
+  const std::chrono::duration<double> wall = end - begin;
+  std::cout << std::setw(12) << name
+            << std::fixed << std::setprecision(1)
+            << std::setw(10) << samples[samples.size() / 2]
+            << std::setw(10) << samples[samples.size() * 99 / 100]
+            << std::setw(10) << samples.back()
+            << std::setw(12) << std::setprecision(0) << static_cast<double>(samples.size() * polls) / wall.count()
+            << '\n';
+}
+
+}// namespace
+
+int main(int argc, char **argv) {
+  size_t polls = 4;
+  if (argc > 1) {
+    polls = std::max(1, std::atoi(argv[1]));
+  }
+  std::cout << "rounds " << rounds << ", polls in round " << polls << ", frame " << frameSize << " bytes\n";
+  std::cout << std::setw(12) << "socket"
+            << std::setw(10) << "p50, us"
+            << std::setw(10) << "p99, us"
+            << std::setw(10) << "max, us"
+            << std::setw(12) << "polls/s" << '\n';
+
+  modbus_gateway::SocketOptions nagle;
+  nagle.noDelay = false;
+  Run("nagle", polls, nagle);
+
+  modbus_gateway::SocketOptions noDelay;
+  noDelay.noDelay = true;
+  Run("no delay", polls, noDelay);
+
+  modbus_gateway::SocketOptions quickAck;
+  quickAck.noDelay = false;
+  quickAck.quickAck = true;
+  Run("quick ack", polls, quickAck);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,135 @@
+#include <common/thread_pool.h>
+#include <common/types_asio.h>
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Compare actor state protection by std::mutex (old transports) and by asio strand (current transports).
+// Every message hop change state of one actor and send message to next actor, like request goes
+// from slave connection to master and back.
+
+namespace {
+
+constexpr size_t actorsCount = 16;
+constexpr size_t chainsCount = 64;
+constexpr size_t hopsPerChain = 20000;
+
+struct ActorState {
+  std::deque<size_t> queue;
+  size_t processed = 0;
+
+  void Process(size_t value) {
+    queue.push_back(value);
+    processed += queue.front();
+    queue.pop_front();
+  }
+};
+
+struct MutexActor {
+  explicit MutexActor(const modbus_gateway::ContextPtr &context)
+      : context(context) {}
+
+  template<typename Handler>
+  void Post(Handler &&handler) {
+    asio::post(*context, [this, handler = std::forward<Handler>(handler)]() mutable {
+      std::lock_guard<std::mutex> lock(m);
+      handler(state);
+    });
+  }
+
+  modbus_gateway::ContextPtr context;
+  std::mutex m;
+  ActorState state;
+};
+
+struct StrandActor {
+  explicit StrandActor(const modbus_gateway::ContextPtr &context)
+      : strand(asio::make_strand(*context)) {}
+
+  template<typename Handler>
+  void Post(Handler &&handler) {
+    asio::post(strand, [this, handler = std::forward<Handler>(handler)]() mutable {
+      handler(state);
+    });
+  }
+
+  asio::strand<modbus_gateway::ContextPtr::element_type::executor_type> strand;
+  ActorState state;
+};
+
+template<typename Actor>
+class Chain {
+public:
+  Chain(std::vector<std::unique_ptr<Actor>> &actors, std::atomic<size_t> &remaining,
+        const modbus_gateway::ContextPtr &context)
+      : actors_(actors), remaining_(remaining), context_(context) {}
+
+  void Hop(size_t actor, size_t hops) {
+    actors_[actor]->Post([this, actor, hops](ActorState &state) {
+      state.Process(hops);
+      if (0 == hops) {
+        if (1 == remaining_.fetch_sub(1)) {
+          context_->stop();
+        }
+        return;
+      }
+      Hop((actor + 1) % actors_.size(), hops - 1);
+    });
+  }
+
+private:
+  std::vector<std::unique_ptr<Actor>> &actors_;
+  std::atomic<size_t> &remaining_;
+  modbus_gateway::ContextPtr context_;
+};
+
+template<typename Actor>
+double Run(size_t threads) {
+  auto context = std::make_shared<modbus_gateway::ContextPtr::element_type>(static_cast<int>(threads));
+
+  std::vector<std::unique_ptr<Actor>> actors;
+  actors.reserve(actorsCount);
+  for (size_t i = 0; i < actorsCount; ++i) {
+    actors.push_back(std::make_unique<Actor>(context));
+  }
+
+  std::atomic<size_t> remaining(chainsCount);
+  std::vector<std::unique_ptr<Chain<Actor>>> chains;
+  chains.reserve(chainsCount);
+  for (size_t i = 0; i < chainsCount; ++i) {
+    chains.push_back(std::make_unique<Chain<Actor>>(actors, remaining, context));
+    chains.back()->Hop(i % actorsCount, hopsPerChain);
+  }
+
+  modbus_gateway::ThreadPool threadPool(context, threads);
+  const auto begin = std::chrono::steady_clock::now();
+  threadPool.Run();
+  threadPool.Join();
+  const auto end = std::chrono::steady_clock::now();
+
+  const std::chrono::duration<double> seconds = end - begin;
+  return static_cast<double>(chainsCount * (hopsPerChain + 1)) / seconds.count();
+}
+
+}// namespace
+
+int main() {
+  std::cout << "actors " << actorsCount << ", chains " << chainsCount << ", hops per chain " << hopsPerChain << '\n';
+  std::cout << std::setw(8) << "threads"
+            << std::setw(20) << "mutex, hop/s"
+            << std::setw(20) << "strand, hop/s" << '\n';
+  for (const size_t threads : {1, 2, 4, 8}) {
+    const double mutexRate = Run<MutexActor>(threads);
+    const double strandRate = Run<StrandActor>(threads);
+    std::cout << std::setw(8) << threads
+              << std::setw(20) << std::fixed << std::setprecision(0) << mutexRate
+              << std::setw(20) << std::fixed << std::setprecision(0) << strandRate << '\n';
+  }
+  return EXIT_SUCCESS;
+}
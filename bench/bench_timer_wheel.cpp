@@ -0,0 +1,89 @@
+#include <common/timer_wheel.h>
+#include <common/types_asio.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// Every queued poll has own deadline which is armed on enqueue and canceled on dequeue.
+// Compare asio waitable timer per message with shared timer wheel.
+
+namespace {
+
+constexpr size_t rounds = 20;
+constexpr auto timeout = std::chrono::seconds(1);
+
+using Timer = asio::basic_waitable_timer<std::chrono::steady_clock>;
+
+double RunTimers(size_t queued) {
+  auto context = std::make_shared<modbus_gateway::ContextPtr::element_type>();
+  std::vector<std::unique_ptr<Timer>> timers;
+  timers.reserve(queued);
+  for (size_t i = 0; i < queued; ++i) {
+    timers.push_back(std::make_unique<Timer>(*context));
+  }
+
+  const auto begin = std::chrono::steady_clock::now();
+  for (size_t round = 0; round < rounds; ++round) {
+    for (auto &timer: timers) {
+      timer->expires_after(timeout);
+      timer->async_wait([](asio::error_code) {});
+    }
+    for (auto &timer: timers) {
+      timer->cancel();
+    }
+    // run canceled handlers
+    context->restart();
+    context->poll();
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  const std::chrono::duration<double> seconds = end - begin;
+  return static_cast<double>(queued * rounds) / seconds.count();
+}
+
+double RunTimerWheel(size_t queued) {
+  auto context = std::make_shared<modbus_gateway::ContextPtr::element_type>();
+  auto timerWheel = std::make_shared<modbus_gateway::TimerWheel>(context, std::chrono::milliseconds(1), 1024);
+  std::vector<modbus_gateway::TimerWheel::Handle> handles(queued);
+
+  const auto begin = std::chrono::steady_clock::now();
+  for (size_t round = 0; round < rounds; ++round) {
+    for (auto &handle: handles) {
+      handle = timerWheel->Arm(timeout, []() {});
+    }
+    for (auto &handle: handles) {
+      timerWheel->Cancel(handle);
+    }
+    context->restart();
+    context->poll();
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  timerWheel->Stop();
+  context->restart();
+  context->poll();
+
+  const std::chrono::duration<double> seconds = end - begin;
+  return static_cast<double>(queued * rounds) / seconds.count();
+}
+
+}// namespace
+
+int main() {
+  std::cout << "rounds " << rounds << ", timeout " << std::chrono::milliseconds(timeout).count() << "ms\n";
+  std::cout << std::setw(10) << "queued"
+            << std::setw(25) << "waitable timer, arm/s"
+            << std::setw(25) << "timer wheel, arm/s" << '\n';
+  for (const size_t queued: {10, 100, 1000, 10000, 100000}) {
+    const double timerRate = RunTimers(queued);
+    const double wheelRate = RunTimerWheel(queued);
+    std::cout << std::setw(10) << queued
+              << std::setw(25) << std::fixed << std::setprecision(0) << timerRate
+              << std::setw(25) << std::fixed << std::setprecision(0) << wheelRate << '\n';
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,69 @@
+#include <common/context_group.h>
+
+#include <common/logger.h>
+
+#include <cassert>
+
+namespace modbus_gateway {
+
+ContextGroup::~ContextGroup() {
+  Stop();
+}
+
+void ContextGroup::SetStartHandler(const ThreadPool::StartHandler &startHandler) {
+  startHandler_ = startHandler;
+}
+
+ContextPtr ContextGroup::Add(size_t threads, const ThreadOptions &threadOptions) {
+  assert(threads > 0);
+  auto context = std::make_shared<ContextPtr::element_type>(static_cast<int>(threads));
+
+  Unit unit;
+  unit.context = context;
+  unit.work = std::make_unique<ContextWork>(context->get_executor());
+  unit.threadPool = std::make_unique<ThreadPool>(context, threads);
+  unit.threadPool->SetFailureHandler([this]() {
+    Stop();
+  });
+  unit.threadPool->SetThreadOptions(threadOptions);
+  unit.threadPool->SetStartHandler(startHandler_);
+  units_.push_back(std::move(unit));
+
+  MG_DEBUG("ContextGroup::Add: context {}, threads {}, cpus {}, priority {}", units_.size() - 1, threads,
+           threadOptions.cpus.size(), threadOptions.priority);
+  return context;
+}
+
+void ContextGroup::Run() {
+  for (auto &unit : units_) {
+    unit.threadPool->Run();
+  }
+}
+
+void ContextGroup::Stop() {
+  for (auto &unit : units_) {
+    unit.threadPool->Stop();
+  }
+}
+
+void ContextGroup::Join() {
+  std::exception_ptr exception = nullptr;
+  for (auto &unit : units_) {
+    try {
+      unit.threadPool->Join();
+    } catch (...) {
+      if (!exception) {
+        exception = std::current_exception();
+      }
+    }
+  }
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+}
+
+size_t ContextGroup::Size() const {
+  return units_.size();
+}
+
+}// namespace modbus_gateway
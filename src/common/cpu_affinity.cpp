@@ -0,0 +1,45 @@
+#include <common/cpu_affinity.h>
+
+#include <common/logger.h>
+
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace modbus_gateway {
+
+size_t GetCpuCount() {
+  const size_t count = std::thread::hardware_concurrency();
+  return count > 0 ? count : 1;
+}
+
+bool SetCurrentThreadAffinity(const CpuSet &cpus) {
+  if (cpus.empty()) {
+    return true;
+  }
+#ifdef __linux__
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  for (const size_t cpu : cpus) {
+    if (cpu >= CPU_SETSIZE) {
+      MG_WARN("SetCurrentThreadAffinity: invalid cpu {}", cpu);
+      return false;
+    }
+    CPU_SET(cpu, &cpuSet);
+  }
+  const int res = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+  if (0 != res) {
+    MG_WARN("SetCurrentThreadAffinity: pthread_setaffinity_np error: {}", res);
+    return false;
+  }
+  return true;
+#else
+  MG_WARN("SetCurrentThreadAffinity: unsupported platform");
+  return false;
+#endif
+}
+
+}// namespace modbus_gateway
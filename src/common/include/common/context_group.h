@@ -0,0 +1,47 @@
+#pragma once
+
+#include <common/realtime.h>
+#include <common/thread_pool.h>
+#include <common/types_asio.h>
+
+#include <memory>
+#include <vector>
+
+namespace modbus_gateway {
+
+// Set of independent io_contexts, every context is run by own thread pool.
+// Failure of one context stops all contexts of group.
+class ContextGroup {
+  struct Unit {
+    ContextPtr context;
+    std::unique_ptr<ContextWork> work;
+    std::unique_ptr<ThreadPool> threadPool;
+  };
+
+public:
+  ContextGroup() = default;
+
+  ContextGroup(const ContextGroup &) = delete;
+  ContextGroup &operator=(const ContextGroup &) = delete;
+
+  ~ContextGroup();
+
+  // Start handler is passed to thread pools of contexts added after call
+  void SetStartHandler(const ThreadPool::StartHandler &startHandler);
+
+  ContextPtr Add(size_t threads, const ThreadOptions &threadOptions = {});
+
+  void Run();
+
+  void Stop();
+
+  void Join();
+
+  size_t Size() const;
+
+private:
+  std::vector<Unit> units_;
+  ThreadPool::StartHandler startHandler_;
+};
+
+}// namespace modbus_gateway
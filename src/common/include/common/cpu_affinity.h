@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace modbus_gateway {
+
+using CpuSet = std::vector<size_t>;
+
+size_t GetCpuCount();
+
+// Pin current thread to cpus, empty set do nothing
+bool SetCurrentThreadAffinity(const CpuSet &cpus);
+
+}// namespace modbus_gateway
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace modbus_gateway {
+
+// Memory for state of one asynchronous operation. Operations of one kind are started one after another,
+// so block is reused without heap allocation. Concurrent or bigger operation goes to heap
+class HandlerMemory {
+public:
+  static constexpr size_t size = 512;
+
+  HandlerMemory()
+      : storage_(), inUse_(false) {}
+
+  HandlerMemory(const HandlerMemory &) = delete;
+  HandlerMemory &operator=(const HandlerMemory &) = delete;
+
+  void *Allocate(size_t bytes) {
+    if (bytes <= size && !inUse_.exchange(true, std::memory_order_acquire)) {
+      return storage_;
+    }
+    return ::operator new(bytes);
+  }
+
+  void Deallocate(void *ptr) {
+    if (ptr == storage_) {
+      inUse_.store(false, std::memory_order_release);
+      return;
+    }
+    ::operator delete(ptr);
+  }
+
+private:
+  alignas(std::max_align_t) unsigned char storage_[size];
+  std::atomic<bool> inUse_;
+};
+
+// Memory is shared with pending operations, they may complete after actor is deleted
+using HandlerMemoryPtr = std::shared_ptr<HandlerMemory>;
+
+template<typename T>
+class HandlerAllocator {
+  template<typename>
+  friend class HandlerAllocator;
+
+public:
+  using value_type = T;
+
+  explicit HandlerAllocator(const HandlerMemoryPtr &memory) noexcept
+      : memory_(memory) {}
+
+  template<typename U>
+  HandlerAllocator(const HandlerAllocator<U> &other) noexcept
+      : memory_(other.memory_) {}
+
+  T *allocate(size_t n) {
+    return static_cast<T *>(memory_->Allocate(sizeof(T) * n));
+  }
+
+  void deallocate(T *ptr, size_t) noexcept {
+    memory_->Deallocate(ptr);
+  }
+
+  template<typename U>
+  bool operator==(const HandlerAllocator<U> &other) const noexcept {
+    return memory_ == other.memory_;
+  }
+
+  template<typename U>
+  bool operator!=(const HandlerAllocator<U> &other) const noexcept {
+    return memory_ != other.memory_;
+  }
+
+private:
+  HandlerMemoryPtr memory_;
+};
+
+// Completion handler with associated allocator, asio takes operation state from handler memory
+template<typename Handler>
+class AllocHandler {
+public:
+  using allocator_type = HandlerAllocator<void>;
+
+  AllocHandler(const HandlerMemoryPtr &memory, Handler handler)
+      : memory_(memory), handler_(std::move(handler)) {}
+
+  allocator_type get_allocator() const noexcept {
+    return allocator_type(memory_);
+  }
+
+  template<typename... Args>
+  void operator()(Args &&...args) {
+    handler_(std::forward<Args>(args)...);
+  }
+
+private:
+  HandlerMemoryPtr memory_;
+  Handler handler_;
+};
+
+template<typename Handler>
+AllocHandler<std::decay_t<Handler>> MakeAllocHandler(const HandlerMemoryPtr &memory, Handler &&handler) {
+  return AllocHandler<std::decay_t<Handler>>(memory, std::forward<Handler>(handler));
+}
+
+}// namespace modbus_gateway
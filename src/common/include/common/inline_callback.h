@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace modbus_gateway {
+
+// Move only callback with inline storage. Unlike std::function it never allocates,
+// callable which does not fit into storage is rejected at compile time
+template<size_t Size>
+class InlineCallback {
+  struct Ops {
+    void (*invoke)(void *storage);
+    void (*move)(void *from, void *to);
+    void (*destroy)(void *storage);
+  };
+
+  template<typename F>
+  static const Ops *MakeOps() {
+    static const Ops ops = {
+        [](void *storage) {
+          (*static_cast<F *>(storage))();
+        },
+        [](void *from, void *to) {
+          new (to) F(std::move(*static_cast<F *>(from)));
+          static_cast<F *>(from)->~F();
+        },
+        [](void *storage) {
+          static_cast<F *>(storage)->~F();
+        }};
+    return &ops;
+  }
+
+public:
+  static constexpr size_t size = Size;
+
+  InlineCallback() noexcept
+      : storage_(), ops_(nullptr) {}
+
+  InlineCallback(std::nullptr_t) noexcept
+      : InlineCallback() {}
+
+  template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, InlineCallback>>>
+  InlineCallback(F &&f)
+      : storage_(), ops_(nullptr) {
+    using Callable = std::decay_t<F>;
+    static_assert(sizeof(Callable) <= Size, "callable does not fit into inline storage");
+    static_assert(alignof(Callable) <= alignof(std::max_align_t), "callable is over aligned");
+    static_assert(std::is_nothrow_move_constructible_v<Callable>, "callable move may throw");
+    new (storage_) Callable(std::forward<F>(f));
+    ops_ = MakeOps<Callable>();
+  }
+
+  InlineCallback(InlineCallback &&other) noexcept
+      : storage_(), ops_(nullptr) {
+    MoveFrom(other);
+  }
+
+  InlineCallback &operator=(InlineCallback &&other) noexcept {
+    if (this != &other) {
+      Reset();
+      MoveFrom(other);
+    }
+    return *this;
+  }
+
+  InlineCallback &operator=(std::nullptr_t) noexcept {
+    Reset();
+    return *this;
+  }
+
+  InlineCallback(const InlineCallback &) = delete;
+  InlineCallback &operator=(const InlineCallback &) = delete;
+
+  ~InlineCallback() {
+    Reset();
+  }
+
+  void operator()() {
+    ops_->invoke(storage_);
+  }
+
+  explicit operator bool() const noexcept {
+    return nullptr != ops_;
+  }
+
+private:
+  void MoveFrom(InlineCallback &other) noexcept {
+    if (other.ops_) {
+      other.ops_->move(other.storage_, storage_);
+      ops_ = other.ops_;
+      other.ops_ = nullptr;
+    }
+  }
+
+  void Reset() noexcept {
+    if (ops_) {
+      ops_->destroy(storage_);
+      ops_ = nullptr;
+    }
+  }
+
+private:
+  alignas(std::max_align_t) unsigned char storage_[Size];
+  const Ops *ops_;
+};
+
+}// namespace modbus_gateway
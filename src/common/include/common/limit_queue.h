@@ -2,52 +2,91 @@
 
 #include <cassert>
 #include <cstddef>
-#include <limits>
-#include <queue>
+#include <utility>
+#include <vector>
 
 namespace modbus_gateway {
 
+// Fixed capacity ring buffer, storage is allocated once in constructor.
+// Push fails when queue is full, caller decides what to drop
 template<typename T>
 class LimitQueue {
 public:
-  explicit LimitQueue(size_t maxSize)
-      : queue_(), maxSize_(maxSize) {
-    assert(maxSize_ > 0);
+  explicit LimitQueue(size_t capacity)
+      : buffer_(capacity), head_(0), size_(0) {
+    assert(capacity > 0);
   }
 
-  LimitQueue()
-      : LimitQueue(std::numeric_limits<size_t>::max()) {}
-
-  void Push(const T &val) {
-    if (queue_.size() > maxSize_) {
-      queue_.pop();
+  bool Push(const T &val) {
+    if (Full()) {
+      return false;
     }
-    queue_.push(val);
+    buffer_[Index(size_)] = val;
+    ++size_;
+    return true;
   }
 
   void Pop() {
-    return queue_.pop();
+    assert(!Empty());
+    // release resources of value, slot is reused later
+    buffer_[head_] = T();
+    head_ = Index(1);
+    --size_;
   }
 
   const T &Front() const {
-    return queue_.front();
+    assert(!Empty());
+    return buffer_[head_];
+  }
+
+  // Position is counted from front
+  const T &At(size_t pos) const {
+    assert(pos < size_);
+    return buffer_[Index(pos)];
+  }
+
+  // Shorter side of queue is shifted over erased value, order is kept
+  void Erase(size_t pos) {
+    assert(pos < size_);
+    if (pos < size_ / 2) {
+      for (size_t i = pos; i > 0; --i) {
+        buffer_[Index(i)] = std::move(buffer_[Index(i - 1)]);
+      }
+      Pop();
+      return;
+    }
+    for (size_t i = pos + 1; i < size_; ++i) {
+      buffer_[Index(i - 1)] = std::move(buffer_[Index(i)]);
+    }
+    buffer_[Index(size_ - 1)] = T();
+    --size_;
   }
 
   size_t Size() const {
-    return queue_.size();
+    return size_;
   }
 
   bool Empty() const {
-    return queue_.empty();
+    return 0 == size_;
+  }
+
+  bool Full() const {
+    return buffer_.size() == size_;
   }
 
-  size_t MaxSize() const {
-    return maxSize_;
+  size_t Capacity() const {
+    return buffer_.size();
+  }
+
+private:
+  size_t Index(size_t pos) const {
+    return (head_ + pos) % buffer_.size();
   }
 
 private:
-  std::queue<T> queue_;
-  size_t maxSize_;
+  std::vector<T> buffer_;
+  size_t head_;
+  size_t size_;
 };
 
 }// namespace modbus_gateway
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
+
+namespace modbus_gateway {
+
+class MemoryBudget;
+
+using MemoryBudgetPtr = std::shared_ptr<MemoryBudget>;
+
+// Byte budget of buffers and messages. Budget with parent is charged together with parent,
+// so connection budget is part of global budget
+class MemoryBudget {
+public:
+  static constexpr size_t unlimited = std::numeric_limits<size_t>::max();
+
+  explicit MemoryBudget(size_t limit, const MemoryBudgetPtr &parent = nullptr);
+
+  MemoryBudget(const MemoryBudget &) = delete;
+  MemoryBudget &operator=(const MemoryBudget &) = delete;
+
+  // Charge this budget and all parents or nothing
+  bool TryCharge(size_t bytes);
+
+  void Release(size_t bytes);
+
+  size_t Used() const;
+
+  size_t Limit() const;
+
+private:
+  size_t limit_;
+  std::atomic<size_t> used_;
+  MemoryBudgetPtr parent_;
+};
+
+// Charged bytes are returned to budget when charge is destroyed
+class MemoryCharge {
+public:
+  MemoryCharge() = default;
+
+  MemoryCharge(const MemoryBudgetPtr &budget, size_t bytes);
+
+  MemoryCharge(const MemoryCharge &) = delete;
+  MemoryCharge &operator=(const MemoryCharge &) = delete;
+
+  MemoryCharge(MemoryCharge &&other) noexcept;
+  MemoryCharge &operator=(MemoryCharge &&other) noexcept;
+
+  ~MemoryCharge();
+
+  // Return empty charge if budget is exhausted
+  static MemoryCharge TryMake(const MemoryBudgetPtr &budget, size_t bytes);
+
+  explicit operator bool() const;
+
+  size_t Bytes() const;
+
+  void Reset();
+
+private:
+  MemoryBudgetPtr budget_ = nullptr;
+  size_t bytes_ = 0;
+};
+
+}// namespace modbus_gateway
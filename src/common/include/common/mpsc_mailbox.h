@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace modbus_gateway {
+
+// Bounded lock-free multi producer single consumer queue (Vyukov bounded queue).
+// Mailbox counts items, producer which makes mailbox non-empty gets wake flag and has to
+// schedule consumer. Consumer calls Release after every item and stops when it return false.
+template<typename T>
+class MpscMailbox {
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+public:
+  explicit MpscMailbox(size_t capacity)
+      : mask_(RoundUpPowerOfTwo(capacity) - 1),
+        cells_(std::make_unique<Cell[]>(mask_ + 1)),
+        enqueuePos_(0),
+        dequeuePos_(0),
+        count_(0) {
+    assert(capacity > 0);
+    for (size_t i = 0; i <= mask_; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpscMailbox(const MpscMailbox &) = delete;
+  MpscMailbox &operator=(const MpscMailbox &) = delete;
+
+  // Any thread. Return false if mailbox is full
+  bool Push(T value, bool &wake) {
+    wake = false;
+    size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    Cell *cell = nullptr;
+    for (;;) {
+      cell = &cells_[pos & mask_];
+      const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+      if (0 == diff) {
+        if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = enqueuePos_.load(std::memory_order_relaxed);
+      }
+    }
+    cell->value = std::move(value);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    wake = (0 == count_.fetch_add(1, std::memory_order_acq_rel));
+    return true;
+  }
+
+  // Consumer only. Return false if next item is not published yet
+  bool Pop(T &value) {
+    Cell &cell = cells_[dequeuePos_ & mask_];
+    const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+    if (sequence != dequeuePos_ + 1) {
+      return false;
+    }
+    value = std::move(cell.value);
+    cell.value = T();
+    cell.sequence.store(dequeuePos_ + mask_ + 1, std::memory_order_release);
+    ++dequeuePos_;
+    return true;
+  }
+
+  // Consumer only, after item is taken. Return true if mailbox has more items
+  bool Release() {
+    return count_.fetch_sub(1, std::memory_order_acq_rel) > 1;
+  }
+
+  size_t Size() const {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+  size_t Capacity() const {
+    return mask_ + 1;
+  }
+
+private:
+  static size_t RoundUpPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+private:
+  const size_t mask_;
+  std::unique_ptr<Cell[]> cells_;
+  alignas(64) std::atomic<size_t> enqueuePos_;
+  alignas(64) size_t dequeuePos_;
+  alignas(64) std::atomic<size_t> count_;
+};
+
+}// namespace modbus_gateway
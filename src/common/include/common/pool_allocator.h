@@ -0,0 +1,247 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace modbus_gateway {
+
+struct PoolStats {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+};
+
+// Counters are shared by all allocators with same tag
+template<typename Tag>
+class PoolCounters {
+public:
+  static void Hit() {
+    hits_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  static void Miss() {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  static PoolStats Get() {
+    return {hits_.load(std::memory_order_relaxed), misses_.load(std::memory_order_relaxed)};
+  }
+
+private:
+  inline static std::atomic<uint64_t> hits_{0};
+  inline static std::atomic<uint64_t> misses_{0};
+};
+
+// Per thread free list of blocks for one type. Block belongs to thread which took it from heap and it returns
+// to cache of this thread: on owner thread to local list, on other thread to lock free return stack of owner.
+// Owner takes whole return stack when local list is empty, so buffer allocated on network thread and released
+// on master thread is reused without heap. Local list keeps at most MaxCached blocks, others are returned to heap
+template<typename T, size_t MaxCached>
+class BlockCache {
+  struct Owner;
+
+  struct Block {
+    union {
+      Block *next;
+      alignas(T) unsigned char storage[sizeof(T)];
+    };
+    Owner *owner;
+  };
+
+  static_assert(alignof(Block) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+
+  struct Owner {
+    // owner thread only
+    Block *head = nullptr;
+    size_t size = 0;
+    // pushed by other threads, taken by owner thread at once
+    std::atomic<Block *> returned{nullptr};
+    // owner thread and every heap block of owner
+    std::atomic<size_t> refs{1};
+  };
+
+  // Trivially destructible, it is usable after cleaner of thread is finished
+  struct Local {
+    Owner *owner;
+    bool closed;
+  };
+
+  struct Cleaner {
+    Local &local;
+
+    ~Cleaner() {
+      if (local.owner) {
+        Close(local.owner);
+      }
+      local.owner = nullptr;
+      local.closed = true;
+    }
+  };
+
+public:
+  // Return block of this thread, nullptr if cache is empty
+  static void *Pop() {
+    Owner *owner = GetOwner();
+    if (!owner) {
+      return nullptr;
+    }
+    if (!owner->head) {
+      owner->head = owner->returned.exchange(nullptr, std::memory_order_acquire);
+      for (Block *block = owner->head; block; block = block->next) {
+        ++owner->size;
+      }
+    }
+    Block *block = owner->head;
+    if (!block) {
+      return nullptr;
+    }
+    owner->head = block->next;
+    --owner->size;
+    return block;
+  }
+
+  // Take block from heap, it belongs to this thread
+  static void *New() {
+    Block *block = static_cast<Block *>(::operator new(sizeof(Block)));
+    block->owner = GetOwner();
+    if (block->owner) {
+      block->owner->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    return block;
+  }
+
+  // Return block to cache of owner thread or to heap
+  static void Push(void *ptr) {
+    Block *block = static_cast<Block *>(ptr);
+    Owner *owner = block->owner;
+    if (!owner) {
+      ::operator delete(block);
+      return;
+    }
+    const Local &local = Get();
+    if (owner == local.owner) {
+      if (owner->size >= MaxCached) {
+        Delete(block);
+        return;
+      }
+      block->next = owner->head;
+      owner->head = block;
+      ++owner->size;
+      return;
+    }
+    Block *head = owner->returned.load(std::memory_order_relaxed);
+    do {
+      if (ClosedMarker() == head) {
+        // owner thread is finished
+        Delete(block);
+        return;
+      }
+      block->next = head;
+    } while (!owner->returned.compare_exchange_weak(head, block, std::memory_order_release,
+                                                    std::memory_order_relaxed));
+  }
+
+private:
+  static Local &Get() {
+    thread_local Local local{nullptr, false};
+    thread_local Cleaner cleaner{local};
+    return local;
+  }
+
+  // nullptr on finished thread, blocks of such thread go to heap
+  static Owner *GetOwner() {
+    Local &local = Get();
+    if (!local.owner && !local.closed) {
+      local.owner = new Owner();
+    }
+    return local.owner;
+  }
+
+  static Block *ClosedMarker() {
+    static Block marker;
+    return &marker;
+  }
+
+  static void Delete(Block *block) {
+    Owner *owner = block->owner;
+    ::operator delete(block);
+    Release(owner);
+  }
+
+  static void Release(Owner *owner) {
+    if (1 == owner->refs.fetch_sub(1, std::memory_order_acq_rel)) {
+      delete owner;
+    }
+  }
+
+  // Blocks released later by other threads go to heap
+  static void Close(Owner *owner) {
+    Block *returned = owner->returned.exchange(ClosedMarker(), std::memory_order_acquire);
+    for (Block *list: {owner->head, returned}) {
+      while (list) {
+        Block *block = list;
+        list = block->next;
+        Delete(block);
+      }
+    }
+    owner->head = nullptr;
+    owner->size = 0;
+    Release(owner);
+  }
+};
+
+// Allocator for std::allocate_shared, object and control block are taken from per thread cache.
+// Single object allocations only, arrays go to heap
+template<typename T, typename Tag, size_t MaxCached = 1024>
+class PoolAllocator {
+  using Cache = BlockCache<T, MaxCached>;
+  using Counters = PoolCounters<Tag>;
+
+public:
+  using value_type = T;
+
+  template<typename U>
+  struct rebind {
+    using other = PoolAllocator<U, Tag, MaxCached>;
+  };
+
+  PoolAllocator() noexcept = default;
+
+  template<typename U>
+  PoolAllocator(const PoolAllocator<U, Tag, MaxCached> &) noexcept {}
+
+  T *allocate(size_t n) {
+    if (1 != n) {
+      return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+    void *ptr = Cache::Pop();
+    if (ptr) {
+      Counters::Hit();
+    } else {
+      Counters::Miss();
+      ptr = Cache::New();
+    }
+    return static_cast<T *>(ptr);
+  }
+
+  void deallocate(T *ptr, size_t n) noexcept {
+    if (1 != n) {
+      ::operator delete(ptr);
+      return;
+    }
+    Cache::Push(ptr);
+  }
+
+  template<typename U>
+  bool operator==(const PoolAllocator<U, Tag, MaxCached> &) const noexcept {
+    return true;
+  }
+
+  template<typename U>
+  bool operator!=(const PoolAllocator<U, Tag, MaxCached> &) const noexcept {
+    return false;
+  }
+};
+
+}// namespace modbus_gateway
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+
+namespace modbus_gateway::profile {
+
+// Compile time limits of memory usage. Embedded profile (MG_EMBEDDED_PROFILE) bounds every queue and cache,
+// so resident memory stops growing with load
+#ifdef MG_EMBEDDED_PROFILE
+inline constexpr bool embedded = true;
+// Messages waiting in master mailbox, and default capacity of master queue
+inline constexpr size_t mailboxCapacity = 64;
+inline constexpr size_t queueDepth = 64;
+// Tcp connections of one server, and transactions of one connection waiting for response
+inline constexpr size_t maxConnections = 16;
+inline constexpr size_t maxInflight = 4;
+// Free blocks kept by pool of one thread, and blocks allocated on thread start
+inline constexpr size_t poolCacheSize = 64;
+inline constexpr size_t poolPreallocate = 32;
+#else
+inline constexpr bool embedded = false;
+inline constexpr size_t mailboxCapacity = 1024;
+inline constexpr size_t queueDepth = 1024;
+inline constexpr size_t maxConnections = std::numeric_limits<size_t>::max();
+inline constexpr size_t maxInflight = 16;
+inline constexpr size_t poolCacheSize = 1024;
+inline constexpr size_t poolPreallocate = 0;
+#endif
+
+// Limits of embedded profile are hard caps, larger value from config is clamped.
+// Limits of default profile are defaults only
+inline constexpr size_t Clamp(size_t value, size_t limit) {
+  return (embedded && value > limit) ? limit : value;
+}
+
+}// namespace modbus_gateway::profile
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <common/cpu_affinity.h>
+
+#include <cstddef>
+
+namespace modbus_gateway {
+
+enum class SchedPolicy {
+  Other,
+  Fifo,
+  RoundRobin,
+};
+
+struct ThreadOptions {
+  CpuSet cpus{};
+  SchedPolicy policy = SchedPolicy::Other;
+  int priority = 0;
+  size_t prefaultStack = 0;
+  size_t prefaultHeap = 0;// heap arena of thread is touched on thread start
+  bool busyPoll = false;// poll context in loop instead of waiting in reactor
+};
+
+struct RealtimeOptions {
+  SchedPolicy policy = SchedPolicy::Other;
+  int priority = 0;
+  int rtuPriority = 0;
+  CpuSet cpuAffinity{};
+  CpuSet rtuCpuAffinity{};
+  bool lockMemory = false;
+  size_t prefaultStack = 0;
+  size_t prefaultHeap = 0;
+};
+
+int GetMinPriority(SchedPolicy policy);
+
+int GetMaxPriority(SchedPolicy policy);
+
+// Apply options to current thread, failures are logged
+void ApplyThreadOptions(const ThreadOptions &options);
+
+bool SetCurrentThreadSchedule(SchedPolicy policy, int priority);
+
+// Lock current and future pages of process in memory. Call before threads start
+bool LockMemory();
+
+void PrefaultStack(size_t size);
+
+// Touch heap pages of current thread arena and keep them in process after free. glibc gives every thread own
+// arena, call on every worker thread
+void PrefaultHeap(size_t size);
+
+// Resident memory of process in bytes, 0 if unknown
+size_t GetResidentMemory();
+
+size_t GetPeakResidentMemory();
+
+}// namespace modbus_gateway
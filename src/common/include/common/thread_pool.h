@@ -0,0 +1,62 @@
+#pragma once
+
+#include <common/realtime.h>
+#include <common/types_asio.h>
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace modbus_gateway {
+
+class ThreadPool {
+public:
+  using FailureHandler = std::function<void()>;
+  using StartHandler = std::function<void()>;
+
+  ThreadPool(const ContextPtr &context, size_t threads);
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  ~ThreadPool();
+
+  void Run();
+
+  void Stop();
+
+  void Join();
+
+  size_t Size() const;
+
+  const ContextPtr &GetContext() const;
+
+  // Called from worker thread after context handler threw exception
+  void SetFailureHandler(const FailureHandler &failureHandler);
+
+  // Applied to every worker thread on start, call before Run
+  void SetThreadOptions(const ThreadOptions &threadOptions);
+
+  // Called from every worker thread on start before context is run, call before Run
+  void SetStartHandler(const StartHandler &startHandler);
+
+private:
+  void Worker(size_t index);
+
+  void SaveException(std::exception_ptr exception);
+
+private:
+  ContextPtr context_;
+  size_t threadsCount_;
+  std::vector<std::thread> threads_;
+  std::mutex m_;
+  std::exception_ptr exception_;
+  FailureHandler failureHandler_;
+  StartHandler startHandler_;
+  ThreadOptions threadOptions_;
+};
+
+}// namespace modbus_gateway
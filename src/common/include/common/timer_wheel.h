@@ -0,0 +1,101 @@
+#pragma once
+
+#include <common/inline_callback.h>
+#include <common/types_asio.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace modbus_gateway {
+
+// Hashed timing wheel shared by many actors, arm and cancel are O(1).
+// Deadline is rounded up to tick, callback is called on wheel strand and must not block,
+// actor posts own work to own executor. Timer wakes wheel at earliest deadline, not on every tick
+class TimerWheel : public std::enable_shared_from_this<TimerWheel> {
+public:
+  // Callback is kept in node, arm does not allocate. Weak reference to actor and shared request fit into it
+  using Callback = InlineCallback<4 * sizeof(void *)>;
+
+  struct Handle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+  };
+
+private:
+  using Clock = std::chrono::steady_clock;
+  using Tick = uint64_t;
+
+  static constexpr uint32_t npos = UINT32_MAX;
+
+  struct Node {
+    Callback callback;
+    Tick target;
+    uint32_t prev;
+    uint32_t next;
+    uint32_t generation;
+    bool armed;
+  };
+
+public:
+  // slots must be power of two
+  TimerWheel(const ContextPtr &context, std::chrono::nanoseconds tick, size_t slots);
+
+  TimerWheel(const TimerWheel &) = delete;
+  TimerWheel &operator=(const TimerWheel &) = delete;
+
+  ~TimerWheel() = default;
+
+  Handle Arm(std::chrono::nanoseconds timeout, Callback callback);
+
+  // Return false if timer already expired or was canceled
+  bool Cancel(Handle &handle);
+
+  size_t Size() const;
+
+  void Stop();
+
+private:
+  void StartTick();
+
+  void OnTick(asio::error_code ec);
+
+  // Wait for earlier deadline which was armed while wheel sleeps
+  void Reschedule();
+
+  void WaitUnsafe();
+
+  Tick NextTargetUnsafe() const;
+
+  uint32_t AllocateNode();
+
+  void LinkNode(uint32_t index);
+
+  void UnlinkNode(uint32_t index);
+
+  void FreeNode(uint32_t index);
+
+private:
+  Strand strand_;
+  asio::basic_waitable_timer<Clock, asio::wait_traits<Clock>, Strand> timer_;
+  const std::chrono::nanoseconds tick_;
+  const size_t mask_;
+  mutable std::mutex m_;
+  std::vector<uint32_t> slots_;
+  std::vector<Node> nodes_;
+  std::vector<uint32_t> freeNodes_;
+  std::vector<Callback> expired_;
+  Clock::time_point start_;
+  Tick current_;
+  Tick wake_;// tick of armed timer
+  size_t count_;
+  bool running_;
+  bool stopped_;
+};
+
+using TimerWheelPtr = std::shared_ptr<TimerWheel>;
+
+}// namespace modbus_gateway
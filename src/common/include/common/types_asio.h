@@ -2,6 +2,8 @@
 
 #include <asio.hpp>
 
+#include <chrono>
+
 namespace modbus_gateway {
 
 using TcpSocketPtr = std::unique_ptr<asio::ip::tcp::socket>;
@@ -10,4 +12,12 @@ using ContextWork = asio::executor_work_guard<ContextPtr::element_type::executor
 using TcpAcceptor = asio::ip::tcp::acceptor;
 using TcpEndpoint = asio::ip::tcp::endpoint;
 
+// Io objects of transports keep strand as concrete executor type. Strand does not fit into inline storage
+// of type erased any_io_executor, it is copied to heap on every operation and post
+using Strand = asio::strand<ContextPtr::element_type::executor_type>;
+using StrandTcpSocket = asio::basic_stream_socket<asio::ip::tcp, Strand>;
+using StrandTcpSocketPtr = std::unique_ptr<StrandTcpSocket>;
+using StrandSerialPort = asio::basic_serial_port<Strand>;
+using StrandTimer = asio::basic_waitable_timer<std::chrono::steady_clock, asio::wait_traits<std::chrono::steady_clock>, Strand>;
+
 }// namespace modbus_gateway
\ No newline at end of file
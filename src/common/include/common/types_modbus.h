@@ -1,11 +1,38 @@
 #pragma once
 
+#include <common/pool_allocator.h>
+#include <common/profile.h>
+
 #include <modbus/modbus_buffer.h>
 
 #include <memory>
+#include <vector>
 
 namespace modbus_gateway {
 
 using ModbusBufferPtr = std::shared_ptr<modbus::ModbusBuffer>;
 
+struct ModbusBufferPoolTag {};
+
+using ModbusBufferAllocator = PoolAllocator<modbus::ModbusBuffer, ModbusBufferPoolTag, profile::poolCacheSize>;
+
+// Buffer is returned to pool of thread which allocated it, also when last reference is released on other thread
+inline ModbusBufferPtr MakeModbusBuffer(modbus::FrameType frameType) {
+  return std::allocate_shared<modbus::ModbusBuffer>(ModbusBufferAllocator(), frameType);
+}
+
+inline PoolStats GetModbusBufferPoolStats() {
+  return PoolCounters<ModbusBufferPoolTag>::Get();
+}
+
+// Fill pool of current thread, next buffers of this thread are taken without heap allocation
+inline void ReserveModbusBuffers(size_t count) {
+  // blocks return to free list of this thread on release
+  std::vector<ModbusBufferPtr> buffers;
+  buffers.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    buffers.push_back(MakeModbusBuffer(modbus::FrameType::TCP));
+  }
+}
+
 }
@@ -0,0 +1,84 @@
+#include <common/memory_budget.h>
+
+#include <cassert>
+#include <utility>
+
+namespace modbus_gateway {
+
+MemoryBudget::MemoryBudget(size_t limit, const MemoryBudgetPtr &parent)
+    : limit_(limit), used_(0), parent_(parent) {}
+
+bool MemoryBudget::TryCharge(size_t bytes) {
+  size_t used = used_.load(std::memory_order_relaxed);
+  do {
+    if (bytes > limit_ - used) {
+      return false;
+    }
+  } while (!used_.compare_exchange_weak(used, used + bytes, std::memory_order_relaxed));
+
+  if (parent_ && !parent_->TryCharge(bytes)) {
+    used_.fetch_sub(bytes, std::memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+void MemoryBudget::Release(size_t bytes) {
+  assert(used_.load(std::memory_order_relaxed) >= bytes);
+  used_.fetch_sub(bytes, std::memory_order_relaxed);
+  if (parent_) {
+    parent_->Release(bytes);
+  }
+}
+
+size_t MemoryBudget::Used() const {
+  return used_.load(std::memory_order_relaxed);
+}
+
+size_t MemoryBudget::Limit() const {
+  return limit_;
+}
+
+MemoryCharge::MemoryCharge(const MemoryBudgetPtr &budget, size_t bytes)
+    : budget_(budget), bytes_(bytes) {}
+
+MemoryCharge::MemoryCharge(MemoryCharge &&other) noexcept
+    : budget_(std::move(other.budget_)), bytes_(std::exchange(other.bytes_, 0)) {}
+
+MemoryCharge &MemoryCharge::operator=(MemoryCharge &&other) noexcept {
+  if (this != &other) {
+    Reset();
+    budget_ = std::move(other.budget_);
+    bytes_ = std::exchange(other.bytes_, 0);
+  }
+  return *this;
+}
+
+MemoryCharge::~MemoryCharge() {
+  Reset();
+}
+
+MemoryCharge MemoryCharge::TryMake(const MemoryBudgetPtr &budget, size_t bytes) {
+  if (!budget || !budget->TryCharge(bytes)) {
+    return {};
+  }
+  return {budget, bytes};
+}
+
+MemoryCharge::operator bool() const {
+  return budget_ != nullptr;
+}
+
+size_t MemoryCharge::Bytes() const {
+  return bytes_;
+}
+
+void MemoryCharge::Reset() {
+  if (budget_) {
+    budget_->Release(bytes_);
+    budget_.reset();
+    bytes_ = 0;
+  }
+}
+
+}// namespace modbus_gateway
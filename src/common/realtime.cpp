@@ -0,0 +1,173 @@
+#include <common/realtime.h>
+
+#include <common/logger.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#ifdef __linux__
+#include <alloca.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+namespace modbus_gateway {
+
+namespace {
+
+size_t GetPageSize() {
+#ifdef __linux__
+  const long pageSize = sysconf(_SC_PAGESIZE);
+  if (pageSize > 0) {
+    return static_cast<size_t>(pageSize);
+  }
+#endif
+  return 4096;
+}
+
+#ifdef __linux__
+int ToNativePolicy(SchedPolicy policy) {
+  switch (policy) {
+  case SchedPolicy::Fifo:
+    return SCHED_FIFO;
+  case SchedPolicy::RoundRobin:
+    return SCHED_RR;
+  case SchedPolicy::Other:
+  default:
+    return SCHED_OTHER;
+  }
+}
+#endif
+
+}// namespace
+
+int GetMinPriority(SchedPolicy policy) {
+#ifdef __linux__
+  return sched_get_priority_min(ToNativePolicy(policy));
+#else
+  (void) policy;
+  return 0;
+#endif
+}
+
+int GetMaxPriority(SchedPolicy policy) {
+#ifdef __linux__
+  return sched_get_priority_max(ToNativePolicy(policy));
+#else
+  (void) policy;
+  return 0;
+#endif
+}
+
+void ApplyThreadOptions(const ThreadOptions &options) {
+  SetCurrentThreadAffinity(options.cpus);
+  if (SchedPolicy::Other != options.policy) {
+    SetCurrentThreadSchedule(options.policy, options.priority);
+  }
+  if (options.prefaultStack > 0) {
+    PrefaultStack(options.prefaultStack);
+  }
+  if (options.prefaultHeap > 0) {
+    PrefaultHeap(options.prefaultHeap);
+  }
+}
+
+bool SetCurrentThreadSchedule(SchedPolicy policy, int priority) {
+#ifdef __linux__
+  sched_param param{};
+  param.sched_priority = priority;
+  const int res = pthread_setschedparam(pthread_self(), ToNativePolicy(policy), &param);
+  if (0 != res) {
+    MG_WARN("SetCurrentThreadSchedule: pthread_setschedparam error: {}", std::strerror(res));
+    return false;
+  }
+  return true;
+#else
+  (void) policy;
+  (void) priority;
+  MG_WARN("SetCurrentThreadSchedule: unsupported platform");
+  return false;
+#endif
+}
+
+bool LockMemory() {
+#ifdef __linux__
+  if (0 != mlockall(MCL_CURRENT | MCL_FUTURE)) {
+    MG_WARN("LockMemory: mlockall error: {}", std::strerror(errno));
+    return false;
+  }
+  return true;
+#else
+  MG_WARN("LockMemory: unsupported platform");
+  return false;
+#endif
+}
+
+void PrefaultStack(size_t size) {
+#ifdef __linux__
+  const size_t pageSize = GetPageSize();
+  auto *stack = static_cast<volatile char *>(alloca(size));
+  for (size_t offset = 0; offset < size; offset += pageSize) {
+    stack[offset] = 0;
+  }
+#else
+  (void) size;
+#endif
+}
+
+void PrefaultHeap(size_t size) {
+#ifdef __GLIBC__
+  // freed memory stays in heap, mmap is not used for big chunks
+  mallopt(M_TRIM_THRESHOLD, -1);
+  mallopt(M_MMAP_MAX, 0);
+#endif
+  auto *heap = static_cast<volatile char *>(std::malloc(size));
+  if (!heap) {
+    MG_WARN("PrefaultHeap: allocation {} bytes failed", size);
+    return;
+  }
+  const size_t pageSize = GetPageSize();
+  for (size_t offset = 0; offset < size; offset += pageSize) {
+    heap[offset] = 0;
+  }
+  std::free(const_cast<char *>(heap));
+}
+
+size_t GetResidentMemory() {
+#ifdef __linux__
+  // second field of statm is resident pages
+  std::ifstream statm("/proc/self/statm");
+  size_t size = 0;
+  size_t resident = 0;
+  if (!(statm >> size >> resident)) {
+    return 0;
+  }
+  return resident * GetPageSize();
+#else
+  return 0;
+#endif
+}
+
+size_t GetPeakResidentMemory() {
+#ifdef __linux__
+  rusage usage{};
+  if (0 != getrusage(RUSAGE_SELF, &usage)) {
+    return 0;
+  }
+  // linux reports kilobytes
+  return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#else
+  return 0;
+#endif
+}
+
+}// namespace modbus_gateway
@@ -0,0 +1,112 @@
+#include <common/thread_pool.h>
+
+#include <common/logger.h>
+
+#include <cassert>
+
+namespace modbus_gateway {
+
+ThreadPool::ThreadPool(const ContextPtr &context, size_t threads)
+    : context_(context), threadsCount_(threads), threads_(), m_(), exception_(nullptr), failureHandler_(), startHandler_(), threadOptions_() {
+  assert(context_);
+  assert(threadsCount_ > 0);
+}
+
+ThreadPool::~ThreadPool() {
+  Stop();
+  for (auto &thread : threads_) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+}
+
+void ThreadPool::Run() {
+  MG_DEBUG("ThreadPool::Run: threads {}", threadsCount_);
+  threads_.reserve(threadsCount_);
+  for (size_t index = 0; index < threadsCount_; ++index) {
+    threads_.emplace_back(&ThreadPool::Worker, this, index);
+  }
+}
+
+void ThreadPool::Stop() {
+  MG_DEBUG("ThreadPool::Stop");
+  context_->stop();
+}
+
+void ThreadPool::Join() {
+  for (auto &thread : threads_) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+  MG_DEBUG("ThreadPool::Join: all threads finished");
+
+  std::exception_ptr exception = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(m_);
+    std::swap(exception, exception_);
+  }
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+}
+
+size_t ThreadPool::Size() const {
+  return threadsCount_;
+}
+
+const ContextPtr &ThreadPool::GetContext() const {
+  return context_;
+}
+
+void ThreadPool::SetFailureHandler(const ThreadPool::FailureHandler &failureHandler) {
+  failureHandler_ = failureHandler;
+}
+
+void ThreadPool::SetThreadOptions(const ThreadOptions &threadOptions) {
+  threadOptions_ = threadOptions;
+}
+
+void ThreadPool::SetStartHandler(const ThreadPool::StartHandler &startHandler) {
+  startHandler_ = startHandler;
+}
+
+void ThreadPool::Worker(size_t index) {
+  MG_DEBUG("ThreadPool::Worker({}): start", index);
+  ApplyThreadOptions(threadOptions_);
+  try {
+    if (startHandler_) {
+      startHandler_();
+    }
+    if (threadOptions_.busyPoll) {
+      while (!context_->stopped()) {
+        context_->poll();
+      }
+    } else {
+      context_->run();
+    }
+  } catch (const std::exception &e) {
+    MG_CRIT("ThreadPool::Worker({}): exception: {}", index, e.what());
+    SaveException(std::current_exception());
+  } catch (...) {
+    MG_CRIT("ThreadPool::Worker({}): unknown exception", index);
+    SaveException(std::current_exception());
+  }
+  MG_DEBUG("ThreadPool::Worker({}): finish", index);
+}
+
+void ThreadPool::SaveException(std::exception_ptr exception) {
+  {
+    std::lock_guard<std::mutex> lock(m_);
+    if (!exception_) {
+      exception_ = std::move(exception);
+    }
+  }
+  context_->stop();
+  if (failureHandler_) {
+    failureHandler_();
+  }
+}
+
+}// namespace modbus_gateway
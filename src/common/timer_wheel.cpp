@@ -0,0 +1,266 @@
+#include <common/timer_wheel.h>
+
+#include <common/logger.h>
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace modbus_gateway {
+
+TimerWheel::TimerWheel(const ContextPtr &context, std::chrono::nanoseconds tick, size_t slots)
+    : strand_(asio::make_strand(*context)),
+      timer_(strand_),
+      tick_(tick),
+      mask_(slots - 1),
+      m_(),
+      slots_(slots, npos),
+      nodes_(),
+      freeNodes_(),
+      expired_(),
+      start_(),
+      current_(0),
+      wake_(0),
+      count_(0),
+      running_(false),
+      stopped_(false) {
+  assert(tick_.count() > 0);
+  assert(slots > 0 && 0 == (slots & mask_));
+  MG_DEBUG("TimerWheel::Ctor: tick {}ns, slots {}", tick_.count(), slots);
+}
+
+TimerWheel::Handle TimerWheel::Arm(std::chrono::nanoseconds timeout, Callback callback) {
+  const Tick ticks = std::max<Tick>(1, (timeout.count() + tick_.count() - 1) / tick_.count());
+  Handle handle;
+  bool start = false;
+  bool reschedule = false;
+  {
+    std::lock_guard<std::mutex> lock(m_);
+    if (stopped_) {
+      return handle;
+    }
+
+    const uint32_t index = AllocateNode();
+    Node &node = nodes_[index];
+    node.callback = std::move(callback);
+    node.armed = true;
+    if (running_) {
+      // wheel sleeps between deadlines, current tick is counted from clock and it is partially passed
+      const Tick now = std::max(current_, static_cast<Tick>((Clock::now() - start_) / tick_));
+      node.target = now + ticks + 1;
+      if (node.target < wake_) {
+        wake_ = node.target;
+        reschedule = true;
+      }
+    } else {
+      // wheel was idle, continue counting from now
+      running_ = true;
+      start = true;
+      start_ = Clock::now() - tick_ * static_cast<std::chrono::nanoseconds::rep>(current_);
+      node.target = current_ + ticks;
+      wake_ = node.target;
+    }
+    LinkNode(index);
+    ++count_;
+    handle = {index, node.generation};
+  }
+
+  if (start) {
+    StartTick();
+  } else if (reschedule) {
+    Reschedule();
+  }
+  return handle;
+}
+
+bool TimerWheel::Cancel(Handle &handle) {
+  // destroy callback after unlock
+  Callback callback;
+  {
+    std::lock_guard<std::mutex> lock(m_);
+    if (handle.index >= nodes_.size()) {
+      return false;
+    }
+    Node &node = nodes_[handle.index];
+    if (!node.armed || node.generation != handle.generation) {
+      handle = {};
+      return false;
+    }
+    callback = std::move(node.callback);
+    UnlinkNode(handle.index);
+    FreeNode(handle.index);
+    --count_;
+  }
+  handle = {};
+  return true;
+}
+
+size_t TimerWheel::Size() const {
+  std::lock_guard<std::mutex> lock(m_);
+  return count_;
+}
+
+void TimerWheel::Stop() {
+  MG_DEBUG("TimerWheel::Stop");
+  {
+    std::lock_guard<std::mutex> lock(m_);
+    stopped_ = true;
+  }
+  std::weak_ptr<TimerWheel> weak = weak_from_this();
+  asio::post(strand_, [weak]() {
+    auto self = weak.lock();
+    if (!self) {
+      return;
+    }
+    self->timer_.cancel();
+  });
+}
+
+void TimerWheel::StartTick() {
+  std::weak_ptr<TimerWheel> weak = weak_from_this();
+  asio::post(strand_, [weak]() {
+    auto self = weak.lock();
+    if (!self) {
+      MG_WARN("TimerWheel::start: wheel was deleted");
+      return;
+    }
+    self->OnTick({});
+  });
+}
+
+void TimerWheel::Reschedule() {
+  std::weak_ptr<TimerWheel> weak = weak_from_this();
+  asio::post(strand_, [weak]() {
+    auto self = weak.lock();
+    if (!self) {
+      MG_WARN("TimerWheel::reschedule: wheel was deleted");
+      return;
+    }
+    std::lock_guard<std::mutex> lock(self->m_);
+    if (self->stopped_ || !self->running_) {
+      return;
+    }
+    // pending wait is canceled and completes with operation aborted
+    self->WaitUnsafe();
+  });
+}
+
+void TimerWheel::WaitUnsafe() {
+  timer_.expires_at(start_ + tick_ * static_cast<std::chrono::nanoseconds::rep>(wake_));
+  std::weak_ptr<TimerWheel> weak = weak_from_this();
+  timer_.async_wait([weak](asio::error_code ec) {
+    auto self = weak.lock();
+    if (!self) {
+      MG_WARN("TimerWheel::tick: wheel was deleted");
+      return;
+    }
+    self->OnTick(ec);
+  });
+}
+
+TimerWheel::Tick TimerWheel::NextTargetUnsafe() const {
+  // targets in slot differ by revolutions, first slot with target of own tick holds earliest deadline
+  Tick earliest = std::numeric_limits<Tick>::max();
+  for (Tick tick = current_ + 1; tick <= current_ + slots_.size(); ++tick) {
+    for (uint32_t index = slots_[tick & mask_]; npos != index; index = nodes_[index].next) {
+      earliest = std::min(earliest, nodes_[index].target);
+    }
+    if (earliest <= tick) {
+      break;
+    }
+  }
+  return earliest;
+}
+
+void TimerWheel::OnTick(asio::error_code ec) {
+  if (ec) {
+    if (asio::error::operation_aborted == ec) {
+      MG_TRACE("TimerWheel::tick: canceled");
+      return;
+    }
+    MG_ERROR("TimerWheel::tick: error: {}", ec.message());
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_);
+    if (stopped_) {
+      running_ = false;
+      return;
+    }
+
+    const Tick due = static_cast<Tick>((Clock::now() - start_) / tick_);
+    while (current_ < due && count_ > 0) {
+      ++current_;
+      uint32_t index = slots_[current_ & mask_];
+      while (npos != index) {
+        Node &node = nodes_[index];
+        const uint32_t next = node.next;
+        if (node.target <= current_) {
+          expired_.push_back(std::move(node.callback));
+          UnlinkNode(index);
+          FreeNode(index);
+          --count_;
+        }
+        index = next;
+      }
+    }
+
+    if (0 == count_) {
+      running_ = false;
+    } else {
+      // sleep until earliest deadline instead of waking on every tick
+      wake_ = NextTargetUnsafe();
+      WaitUnsafe();
+    }
+  }
+
+  for (auto &callback: expired_) {
+    callback();
+  }
+  expired_.clear();
+}
+
+uint32_t TimerWheel::AllocateNode() {
+  if (!freeNodes_.empty()) {
+    const uint32_t index = freeNodes_.back();
+    freeNodes_.pop_back();
+    return index;
+  }
+  nodes_.push_back({nullptr, 0, npos, npos, 0, false});
+  return static_cast<uint32_t>(nodes_.size() - 1);
+}
+
+void TimerWheel::LinkNode(uint32_t index) {
+  Node &node = nodes_[index];
+  uint32_t &head = slots_[node.target & mask_];
+  node.prev = npos;
+  node.next = head;
+  if (npos != head) {
+    nodes_[head].prev = index;
+  }
+  head = index;
+}
+
+void TimerWheel::UnlinkNode(uint32_t index) {
+  Node &node = nodes_[index];
+  if (npos != node.prev) {
+    nodes_[node.prev].next = node.next;
+  } else {
+    slots_[node.target & mask_] = node.next;
+  }
+  if (npos != node.next) {
+    nodes_[node.next].prev = node.prev;
+  }
+}
+
+void TimerWheel::FreeNode(uint32_t index) {
+  Node &node = nodes_[index];
+  node.callback = nullptr;
+  node.prev = npos;
+  node.next = npos;
+  node.armed = false;
+  ++node.generation;
+  freeNodes_.push_back(index);
+}
+
+}// namespace modbus_gateway
@@ -12,8 +12,27 @@ ConfigService::ConfigService(TracePath &tp, const nlohmann::json::value_type &da
 
   auto threadsOpt = ExtractUnsignedNumberOpt<size_t>(tp, data, keys::threads);
   if (threadsOpt.has_value()) {
+    if (0 == threadsOpt.value()) {
+      TraceDeep td(tp, keys::threads);
+      throw InvalidValueException(td, std::to_string(threadsOpt.value()));
+    }
     threads = threadsOpt.value();
   }
+
+  auto rtuContextOpt = ExtractRtuContextMode(tp, data);
+  if (rtuContextOpt.has_value()) {
+    rtuContext = rtuContextOpt.value();
+  }
+
+  realtime = ExtractRealtimeOptions(tp, data);
+  busyPoll = ExtractBusyPollOptions(tp, data);
+
+  auto deliveryOpt = ExtractDelivery(tp, data);
+  if (deliveryOpt.has_value()) {
+    delivery = deliveryOpt.value();
+  }
+
+  memoryBudget = ExtractMemoryBudgetOptions(tp, data);
 }
 
 }// namespace modbus_gateway
@@ -86,4 +86,50 @@ std::optional<NumericRangeType> ConvertNumericRangeType(const std::string &numer
   return std::nullopt;
 }
 
+std::optional<RtuContextMode> ConvertRtuContextMode(const std::string &rtuContextMode) {
+  if ("shared" == rtuContextMode) {
+    return RtuContextMode::Shared;
+  }
+  if ("dedicated" == rtuContextMode) {
+    return RtuContextMode::Dedicated;
+  }
+  if ("per_device" == rtuContextMode) {
+    return RtuContextMode::PerDevice;
+  }
+  return std::nullopt;
+}
+
+std::optional<SchedPolicy> ConvertSchedPolicy(const std::string &schedPolicy) {
+  if ("other" == schedPolicy) {
+    return SchedPolicy::Other;
+  }
+  if ("fifo" == schedPolicy) {
+    return SchedPolicy::Fifo;
+  }
+  if ("rr" == schedPolicy) {
+    return SchedPolicy::RoundRobin;
+  }
+  return std::nullopt;
+}
+
+std::optional<Delivery> ConvertDelivery(const std::string &delivery) {
+  if ("post" == delivery) {
+    return Delivery::Post;
+  }
+  if ("inline" == delivery) {
+    return Delivery::Inline;
+  }
+  return std::nullopt;
+}
+
+std::optional<DropPolicy> ConvertDropPolicy(const std::string &dropPolicy) {
+  if ("drop_oldest" == dropPolicy) {
+    return DropPolicy::DropOldest;
+  }
+  if ("reject_newest" == dropPolicy) {
+    return DropPolicy::RejectNewest;
+  }
+  return std::nullopt;
+}
+
 }// namespace modbus_gateway
@@ -9,6 +9,8 @@
 #include <config/tcp_client_config.h>
 #include <config/tcp_server_config.h>
 
+#include <common/profile.h>
+
 #include <nlohmann/json.hpp>
 
 namespace modbus_gateway {
@@ -32,6 +34,13 @@ void CheckType(const TraceDeep &td, const nlohmann::json::value_type &obj, Value
   }
 }
 
+void CheckProfileLimit(TracePath &tracePath, const std::string &key, size_t value, size_t limit) {
+  if (profile::embedded && value > limit) {
+    TraceDeep td(tracePath, key);
+    throw InvalidValueException(td, std::to_string(value));
+  }
+}
+
 std::string ExtractString(TracePath &tracePath, const nlohmann::json::value_type &obj, const std::string &key) {
   TraceDeep td(tracePath, key);
   const auto &res = FindObject(td, obj);
@@ -78,6 +87,229 @@ std::optional<Logger::LogLevel> ExtractLogLevel(TracePath &tracePath, const nloh
   return convertValue.value();
 }
 
+std::optional<RtuContextMode> ExtractRtuContextMode(TracePath &tracePath, const nlohmann::json::value_type &obj) {
+  TraceDeep td(tracePath, keys::rtuContext);
+
+  const auto it = FindObjectRaw(td, obj);
+  if (obj.end() == it) {
+    return std::nullopt;
+  }
+  const auto &val = it.value();
+  CheckType(td, val, ValueType::String);
+
+  const auto &value = val.get<std::string>();
+  const auto convertValue = ConvertRtuContextMode(value);
+  if (!convertValue.has_value()) {
+    throw InvalidValueException(td, value);
+  }
+  return convertValue.value();
+}
+
+std::optional<SchedPolicy> ExtractSchedPolicy(TracePath &tracePath, const nlohmann::json::value_type &obj) {
+  TraceDeep td(tracePath, keys::policy);
+
+  const auto it = FindObjectRaw(td, obj);
+  if (obj.end() == it) {
+    return std::nullopt;
+  }
+  const auto &val = it.value();
+  CheckType(td, val, ValueType::String);
+
+  const auto &value = val.get<std::string>();
+  const auto convertValue = ConvertSchedPolicy(value);
+  if (!convertValue.has_value()) {
+    throw InvalidValueException(td, value);
+  }
+  return convertValue.value();
+}
+
+CpuSet ExtractCpuSet(TracePath &tracePath, const nlohmann::json::value_type &obj, const std::string &key) {
+  TraceDeep td(tracePath, key);
+
+  const auto it = FindObjectRaw(td, obj);
+  if (obj.end() == it) {
+    return {};
+  }
+  const auto &cpus = it.value();
+  CheckType(td, cpus, ValueType::Array);
+
+  const size_t cpuCount = GetCpuCount();
+  CpuSet result;
+  result.reserve(cpus.size());
+  for (size_t index = 0; index < cpus.size(); ++index) {
+    TraceDeep tdCpu(td.GetTracePath(), std::to_string(index));
+    const auto &cpu = cpus[index];
+    CheckType(tdCpu, cpu, ValueType::Number);
+    const auto value = cpu.get<uint64_t>();
+    if (value >= cpuCount) {
+      throw InvalidValueException(tdCpu, std::to_string(value));
+    }
+    result.push_back(static_cast<size_t>(value));
+  }
+  return result;
+}
+
+std::optional<RealtimeOptions> ExtractRealtimeOptions(TracePath &tracePath, const nlohmann::json::value_type &obj) {
+  TraceDeep td(tracePath, keys::realtime);
+  const auto it = FindObjectRaw(td, obj);
+  if (obj.end() == it) {
+    return std::nullopt;
+  }
+  const auto &val = it.value();
+  CheckType(td, val, ValueType::Object);
+
+  auto &tp = td.GetTracePath();
+
+  RealtimeOptions realtime;
+  const auto policyOpt = ExtractSchedPolicy(tp, val);
+  if (policyOpt.has_value()) {
+    realtime.policy = policyOpt.value();
+  }
+
+  const int minPriority = GetMinPriority(realtime.policy);
+  const int maxPriority = GetMaxPriority(realtime.policy);
+  const auto checkPriority = [&tp, minPriority, maxPriority](int priority, const std::string &key) {
+    if (priority < minPriority || priority > maxPriority) {
+      TraceDeep tdPriority(tp, key);
+      throw InvalidValueException(tdPriority, std::to_string(priority));
+    }
+  };
+  realtime.priority = minPriority;
+  const auto priorityOpt = ExtractUnsignedNumberOpt<uint8_t>(tp, val, keys::priority);
+  if (priorityOpt.has_value()) {
+    realtime.priority = priorityOpt.value();
+    checkPriority(realtime.priority, keys::priority);
+  }
+  realtime.rtuPriority = realtime.priority;
+  const auto rtuPriorityOpt = ExtractUnsignedNumberOpt<uint8_t>(tp, val, keys::rtuPriority);
+  if (rtuPriorityOpt.has_value()) {
+    realtime.rtuPriority = rtuPriorityOpt.value();
+    checkPriority(realtime.rtuPriority, keys::rtuPriority);
+  }
+
+  realtime.cpuAffinity = ExtractCpuSet(tp, val, keys::cpuAffinity);
+  realtime.rtuCpuAffinity = realtime.cpuAffinity;
+  if (val.end() != val.find(keys::rtuCpuAffinity)) {
+    realtime.rtuCpuAffinity = ExtractCpuSet(tp, val, keys::rtuCpuAffinity);
+  }
+
+  const auto mlockallOpt = ExtractValueOpt<bool>(tp, val, keys::mlockall, ValueType::Boolean);
+  if (mlockallOpt.has_value()) {
+    realtime.lockMemory = mlockallOpt.value();
+  }
+
+  const auto prefaultStackOpt = ExtractUnsignedNumberOpt<size_t>(tp, val, keys::prefaultStack);
+  if (prefaultStackOpt.has_value()) {
+    // default thread stack is 8 MiB, keep room for handlers
+    constexpr size_t maxPrefaultStack = 4 * 1024 * 1024;
+    if (prefaultStackOpt.value() > maxPrefaultStack) {
+      TraceDeep tdStack(tp, keys::prefaultStack);
+      throw InvalidValueException(tdStack, std::to_string(prefaultStackOpt.value()));
+    }
+    realtime.prefaultStack = prefaultStackOpt.value();
+  }
+
+  const auto prefaultHeapOpt = ExtractUnsignedNumberOpt<size_t>(tp, val, keys::prefaultHeap);
+  if (prefaultHeapOpt.has_value()) {
+    realtime.prefaultHeap = prefaultHeapOpt.value();
+  }
+
+  return realtime;
+}
+
+std::optional<BusyPollOptions> ExtractBusyPollOptions(TracePath &tracePath, const nlohmann::json::value_type &obj) {
+  TraceDeep td(tracePath, keys::busyPoll);
+  const auto it = FindObjectRaw(td, obj);
+  if (obj.end() == it) {
+    return std::nullopt;
+  }
+  const auto &val = it.value();
+  CheckType(td, val, ValueType::Object);
+
+  auto &tp = td.GetTracePath();
+
+  BusyPollOptions busyPoll;
+  const auto networkOpt = ExtractValueOpt<bool>(tp, val, keys::busyPollNetwork, ValueType::Boolean);
+  if (networkOpt.has_value()) {
+    busyPoll.network = networkOpt.value();
+  }
+  const auto rtuOpt = ExtractValueOpt<bool>(tp, val, keys::busyPollRtu, ValueType::Boolean);
+  if (rtuOpt.has_value()) {
+    busyPoll.rtu = rtuOpt.value();
+  }
+  busyPoll.socket = ExtractUnsignedNumberOpt<uint32_t>(tp, val, keys::busyPollSocket);
+
+  return busyPoll;
+}
+
+std::optional<Delivery> ExtractDelivery(TracePath &tracePath, const nlohmann::json::value_type &obj) {
+  TraceDeep td(tracePath, keys::delivery);
+
+  const auto it = FindObjectRaw(td, obj);
+  if (obj.end() == it) {
+    return std::nullopt;
+  }
+  const auto &val = it.value();
+  CheckType(td, val, ValueType::String);
+
+  const auto &value = val.get<std::string>();
+  const auto convertValue = ConvertDelivery(value);
+  if (!convertValue.has_value()) {
+    throw InvalidValueException(td, value);
+  }
+  return convertValue.value();
+}
+
+std::optional<DropPolicy> ExtractDropPolicy(TracePath &tracePath, const nlohmann::json::value_type &obj) {
+  TraceDeep td(tracePath, keys::dropPolicy);
+
+  const auto it = FindObjectRaw(td, obj);
+  if (obj.end() == it) {
+    return std::nullopt;
+  }
+  const auto &val = it.value();
+  CheckType(td, val, ValueType::String);
+
+  const auto &value = val.get<std::string>();
+  const auto convertValue = ConvertDropPolicy(value);
+  if (!convertValue.has_value()) {
+    throw InvalidValueException(td, value);
+  }
+  return convertValue.value();
+}
+
+std::optional<MemoryBudgetOptions> ExtractMemoryBudgetOptions(TracePath &tracePath, const nlohmann::json::value_type &obj) {
+  TraceDeep td(tracePath, keys::memoryBudget);
+  const auto it = FindObjectRaw(td, obj);
+  if (obj.end() == it) {
+    return std::nullopt;
+  }
+  const auto &val = it.value();
+  CheckType(td, val, ValueType::Object);
+
+  auto &tp = td.GetTracePath();
+
+  MemoryBudgetOptions memoryBudget;
+  const auto connectionOpt = ExtractUnsignedNumberOpt<size_t>(tp, val, keys::memoryBudgetConnection);
+  if (connectionOpt.has_value()) {
+    if (0 == connectionOpt.value()) {
+      TraceDeep tdConnection(tp, keys::memoryBudgetConnection);
+      throw InvalidValueException(tdConnection, std::to_string(connectionOpt.value()));
+    }
+    memoryBudget.connection = connectionOpt.value();
+  }
+  const auto globalOpt = ExtractUnsignedNumberOpt<size_t>(tp, val, keys::memoryBudgetGlobal);
+  if (globalOpt.has_value()) {
+    if (0 == globalOpt.value()) {
+      TraceDeep tdGlobal(tp, keys::memoryBudgetGlobal);
+      throw InvalidValueException(tdGlobal, std::to_string(globalOpt.value()));
+    }
+    memoryBudget.global = globalOpt.value();
+  }
+
+  return memoryBudget;
+}
+
 modbus::FrameType ExtractFrameType(TracePath &tracePath, const nlohmann::json::value_type &obj) {
   TraceDeep td(tracePath, keys::frame_type);
 
@@ -134,6 +366,69 @@ asio::ip::port_type ExtractIpPort(TracePath &tracePath, const nlohmann::json::va
   return static_cast<asio::ip::port_type>(value);
 }
 
+SocketOptions ExtractSocketOptions(TracePath &tracePath, const nlohmann::json::value_type &obj) {
+  SocketOptions socketOptions{};
+
+  TraceDeep td(tracePath, keys::socket);
+  const auto it = FindObjectRaw(td, obj);
+  if (obj.end() == it) {
+    return socketOptions;
+  }
+  const auto &val = it.value();
+  CheckType(td, val, ValueType::Object);
+
+  auto &tp = td.GetTracePath();
+
+  socketOptions.noDelay = ExtractValueOpt<bool>(tp, val, keys::noDelay, ValueType::Boolean);
+  socketOptions.quickAck = ExtractValueOpt<bool>(tp, val, keys::quickAck, ValueType::Boolean);
+  socketOptions.receiveBuffer = ExtractUnsignedNumberOpt<int32_t>(tp, val, keys::receiveBuffer);
+  socketOptions.sendBuffer = ExtractUnsignedNumberOpt<int32_t>(tp, val, keys::sendBuffer);
+  socketOptions.keepAlive = ExtractValueOpt<bool>(tp, val, keys::keepAlive, ValueType::Boolean);
+
+  // kernel rejects zero keep alive parameters
+  const auto keepAliveIdleOpt = ExtractUnsignedNumberOpt<int32_t>(tp, val, keys::keepAliveIdle);
+  if (keepAliveIdleOpt.has_value()) {
+    if (0 == keepAliveIdleOpt.value()) {
+      TraceDeep keyTd(tp, keys::keepAliveIdle);
+      throw InvalidValueException(keyTd, std::to_string(keepAliveIdleOpt.value()));
+    }
+    socketOptions.keepAliveIdle = keepAliveIdleOpt.value();
+  }
+
+  const auto keepAliveIntervalOpt = ExtractUnsignedNumberOpt<int32_t>(tp, val, keys::keepAliveInterval);
+  if (keepAliveIntervalOpt.has_value()) {
+    if (0 == keepAliveIntervalOpt.value()) {
+      TraceDeep keyTd(tp, keys::keepAliveInterval);
+      throw InvalidValueException(keyTd, std::to_string(keepAliveIntervalOpt.value()));
+    }
+    socketOptions.keepAliveInterval = keepAliveIntervalOpt.value();
+  }
+
+  const auto keepAliveCountOpt = ExtractUnsignedNumberOpt<int32_t>(tp, val, keys::keepAliveCount);
+  if (keepAliveCountOpt.has_value()) {
+    if (0 == keepAliveCountOpt.value()) {
+      TraceDeep keyTd(tp, keys::keepAliveCount);
+      throw InvalidValueException(keyTd, std::to_string(keepAliveCountOpt.value()));
+    }
+    socketOptions.keepAliveCount = keepAliveCountOpt.value();
+  }
+
+  socketOptions.userTimeout = ExtractUnsignedNumberOpt<int32_t>(tp, val, keys::userTimeout);
+  socketOptions.priority = ExtractUnsignedNumberOpt<int32_t>(tp, val, keys::socketPriority);
+
+  // six bits of traffic class
+  const auto dscpOpt = ExtractUnsignedNumberOpt<uint8_t>(tp, val, keys::dscp);
+  if (dscpOpt.has_value()) {
+    if (dscpOpt.value() > 63) {
+      TraceDeep keyTd(tp, keys::dscp);
+      throw InvalidValueException(keyTd, std::to_string(dscpOpt.value()));
+    }
+    socketOptions.dscp = dscpOpt.value();
+  }
+
+  return socketOptions;
+}
+
 std::optional<Rs485> ExtractRs485Options(TracePath &tracePath, const nlohmann::json::value_type &obj) {
   TraceDeep td(tracePath, keys::rs485);
   const auto it = FindObjectRaw(td, obj);
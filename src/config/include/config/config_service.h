@@ -1,11 +1,16 @@
 #pragma once
 
+#include <config/config_types.h>
 #include <config/trace_path.h>
 
 #include <common/logger.h>
+#include <common/realtime.h>
+#include <transport/delivery.h>
 
 #include <nlohmann/json.hpp>
 
+#include <optional>
+
 namespace modbus_gateway {
 
 struct ConfigService {
@@ -14,6 +19,11 @@ struct ConfigService {
 
   Logger::LogLevel logLevel = Logger::LogLevel::Info;
   size_t threads = 1;
+  RtuContextMode rtuContext = RtuContextMode::Shared;
+  std::optional<RealtimeOptions> realtime{};
+  std::optional<BusyPollOptions> busyPoll{};
+  Delivery delivery = Delivery::Post;
+  std::optional<MemoryBudgetOptions> memoryBudget{};
 };
 
 }// namespace modbus_gateway
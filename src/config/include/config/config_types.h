@@ -1,5 +1,10 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+
 namespace modbus_gateway {
 
 enum class NumericRangeType {
@@ -7,4 +12,21 @@ enum class NumericRangeType {
   Value
 };
 
+enum class RtuContextMode {
+  Shared,// rtu transports share context with network transports
+  Dedicated,// all rtu transports use one own context and thread
+  PerDevice,// every serial device uses own context and thread
+};
+
+struct BusyPollOptions {
+  bool network = false;
+  bool rtu = false;
+  std::optional<uint32_t> socket{};
+};
+
+struct MemoryBudgetOptions {
+  size_t connection = std::numeric_limits<size_t>::max();
+  size_t global = std::numeric_limits<size_t>::max();
+};
+
 }
@@ -3,7 +3,10 @@
 #include <config/config_types.h>
 
 #include <common/logger.h>
+#include <common/realtime.h>
 #include <common/types_asio.h>
+#include <transport/delivery.h>
+#include <transport/drop_policy.h>
 
 #include <modbus/modbus_types.h>
 
@@ -24,4 +27,12 @@ std::optional<asio::serial_port_base::flow_control::type> ConvertFlowControl(con
 
 std::optional<NumericRangeType> ConvertNumericRangeType(const std::string &numericRangeType);
 
+std::optional<RtuContextMode> ConvertRtuContextMode(const std::string &rtuContextMode);
+
+std::optional<SchedPolicy> ConvertSchedPolicy(const std::string &schedPolicy);
+
+std::optional<Delivery> ConvertDelivery(const std::string &delivery);
+
+std::optional<DropPolicy> ConvertDropPolicy(const std::string &dropPolicy);
+
 }// namespace modbus_gateway
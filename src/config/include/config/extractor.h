@@ -9,8 +9,12 @@
 #include <config/value_type.h>
 
 #include <common/logger.h>
+#include <common/realtime.h>
 #include <common/types_asio.h>
+#include <transport/delivery.h>
+#include <transport/drop_policy.h>
 #include <transport/rtu_options.h>
+#include <transport/socket_options.h>
 
 #include <modbus/modbus_types.h>
 
@@ -64,6 +68,9 @@ std::optional<T> ExtractUnsignedNumberOpt(TracePath &tracePath, const nlohmann::
   return static_cast<T>(value);
 }
 
+// Value over limit of embedded profile is rejected, limits of default profile are defaults only
+void CheckProfileLimit(TracePath &tracePath, const std::string &key, size_t value, size_t limit);
+
 template<typename T>
 T ExtractUnsignedNumber(TracePath &tracePath, const nlohmann::json::value_type &obj, const std::string &key) {
   const auto resultOpt = ExtractUnsignedNumberOpt<T>(tracePath, obj, key);
@@ -82,6 +89,22 @@ ConfigService ExtractConfigService(TracePath &tracePath, const nlohmann::json::v
 
 std::optional<Logger::LogLevel> ExtractLogLevel(TracePath &tracePath, const nlohmann::json::value_type &obj);
 
+std::optional<RtuContextMode> ExtractRtuContextMode(TracePath &tracePath, const nlohmann::json::value_type &obj);
+
+std::optional<SchedPolicy> ExtractSchedPolicy(TracePath &tracePath, const nlohmann::json::value_type &obj);
+
+CpuSet ExtractCpuSet(TracePath &tracePath, const nlohmann::json::value_type &obj, const std::string &key);
+
+std::optional<RealtimeOptions> ExtractRealtimeOptions(TracePath &tracePath, const nlohmann::json::value_type &obj);
+
+std::optional<BusyPollOptions> ExtractBusyPollOptions(TracePath &tracePath, const nlohmann::json::value_type &obj);
+
+std::optional<Delivery> ExtractDelivery(TracePath &tracePath, const nlohmann::json::value_type &obj);
+
+std::optional<DropPolicy> ExtractDropPolicy(TracePath &tracePath, const nlohmann::json::value_type &obj);
+
+std::optional<MemoryBudgetOptions> ExtractMemoryBudgetOptions(TracePath &tracePath, const nlohmann::json::value_type &obj);
+
 modbus::FrameType ExtractFrameType(TracePath &tracePath, const nlohmann::json::value_type &obj);
 
 std::optional<asio::ip::address> ExtractIpAddressOptional(TracePath &tracePath, const nlohmann::json::value_type &obj);
@@ -90,6 +113,8 @@ asio::ip::address ExtractIpAddress(TracePath &tracePath, const nlohmann::json::v
 
 asio::ip::port_type ExtractIpPort(TracePath &tracePath, const nlohmann::json::value_type &obj);
 
+SocketOptions ExtractSocketOptions(TracePath &tracePath, const nlohmann::json::value_type &obj);
+
 std::optional<Rs485> ExtractRs485Options(TracePath &tracePath, const nlohmann::json::value_type &obj);
 
 RtuOptions ExtractRtuOptions(TracePath &tracePath, const nlohmann::json::value_type &obj);
@@ -13,14 +13,54 @@ const std::string masters = "masters";
 const std::string version = "version";
 const std::string logLevel = "log_level";
 const std::string threads = "threads";
+const std::string rtuContext = "rtu_context";
+const std::string realtime = "realtime";
+const std::string policy = "policy";
+const std::string priority = "priority";
+const std::string rtuPriority = "rtu_priority";
+const std::string cpuAffinity = "cpu_affinity";
+const std::string rtuCpuAffinity = "rtu_cpu_affinity";
+const std::string mlockall = "mlockall";
+const std::string prefaultStack = "prefault_stack";
+const std::string prefaultHeap = "prefault_heap";
+const std::string busyPoll = "busy_poll";
+const std::string busyPollNetwork = "network";
+const std::string busyPollRtu = "rtu";
+const std::string busyPollSocket = "socket_us";
+const std::string delivery = "delivery";
+const std::string memoryBudget = "memory_budget";
+const std::string memoryBudgetConnection = "connection_bytes";
+const std::string memoryBudgetGlobal = "global_bytes";
 
 // common
 const std::string frame_type = "frame_type";
 const std::string timeout = "timeout_ms";
 
+// master
+const std::string queueSize = "queue_size";
+const std::string dropPolicy = "drop_policy";
+
 // tcp
 const std::string ipAddress = "ip_address";
 const std::string ipPort = "ip_port";
+const std::string shards = "shards";
+const std::string maxInflight = "max_inflight";
+const std::string maxConnections = "max_connections";
+const std::string maxConnectionsPerIp = "max_connections_per_ip";
+const std::string idleTimeout = "idle_timeout_ms";
+const std::string evictIdle = "evict_idle";
+const std::string socket = "socket";
+const std::string noDelay = "no_delay";
+const std::string quickAck = "quick_ack";
+const std::string receiveBuffer = "receive_buffer";
+const std::string sendBuffer = "send_buffer";
+const std::string keepAlive = "keep_alive";
+const std::string keepAliveIdle = "keep_alive_idle_s";
+const std::string keepAliveInterval = "keep_alive_interval_s";
+const std::string keepAliveCount = "keep_alive_count";
+const std::string userTimeout = "user_timeout_ms";
+const std::string socketPriority = "priority";
+const std::string dscp = "dscp";
 
 // rtu
 const std::string device = "device";
@@ -3,6 +3,9 @@
 #include <config/trace_path.h>
 #include <config/unit_id_range.h>
 
+#include <common/profile.h>
+#include <transport/drop_policy.h>
+
 #include <nlohmann/json.hpp>
 
 #include <chrono>
@@ -18,6 +21,8 @@ public:
 
   std::chrono::milliseconds timeout = std::chrono::milliseconds(1000);
   std::vector<UnitIdRange> unitIdSet{};
+  size_t queueSize = profile::queueDepth;
+  DropPolicy dropPolicy = DropPolicy::DropOldest;
 };
 
 using ClientConfigPtr = std::shared_ptr<MasterConfig>;
@@ -6,6 +6,7 @@
 #include <config/unit_id_range.h>
 
 #include <common/types_asio.h>
+#include <transport/socket_options.h>
 
 #include <nlohmann/json.hpp>
 
@@ -19,6 +20,7 @@ public:
 
   asio::ip::address address = asio::ip::address_v4::any();
   asio::ip::port_type port = 502;
+  SocketOptions socketOptions{};
 };
 
 }// namespace modbus_gateway
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <common/profile.h>
 #include <common/types_asio.h>
 #include <config/i_transport_config.h>
 #include <config/trace_path.h>
+#include <transport/connection_limits.h>
+#include <transport/socket_options.h>
 
 #include <nlohmann/json.hpp>
 
@@ -16,6 +19,10 @@ public:
 
   asio::ip::address address = asio::ip::address_v4::any();
   asio::ip::port_type port = 502;
+  size_t shards = 0;
+  size_t maxInflight = profile::maxInflight;
+  ConnectionLimits connectionLimits{};
+  SocketOptions socketOptions{};
 };
 
 }// namespace modbus_gateway
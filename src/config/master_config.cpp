@@ -12,6 +12,21 @@ MasterConfig::MasterConfig( TracePath& tracePath, const nlohmann::json::value_ty
   if (unitIdSetOpt.has_value()) {
     unitIdSet = unitIdSetOpt.value();
   }
+
+  const auto queueSizeOpt = ExtractUnsignedNumberOpt<size_t>(tracePath, obj, keys::queueSize);
+  if (queueSizeOpt.has_value()) {
+    if (0 == queueSizeOpt.value()) {
+      TraceDeep td(tracePath, keys::queueSize);
+      throw InvalidValueException(td, std::to_string(queueSizeOpt.value()));
+    }
+    CheckProfileLimit(tracePath, keys::queueSize, queueSizeOpt.value(), profile::queueDepth);
+    queueSize = queueSizeOpt.value();
+  }
+
+  const auto dropPolicyOpt = ExtractDropPolicy(tracePath, obj);
+  if (dropPolicyOpt.has_value()) {
+    dropPolicy = dropPolicyOpt.value();
+  }
 }
 
 }
\ No newline at end of file
@@ -9,6 +9,7 @@ TcpClientConfig::TcpClientConfig(TracePath &tracePath, const nlohmann::json::val
       MasterConfig(tracePath, obj) {
   address = ExtractIpAddress(tracePath, obj);
   port = ExtractIpPort(tracePath, obj);
+  socketOptions = ExtractSocketOptions(tracePath, obj);
 }
 
 }// namespace modbus_gateway
@@ -13,6 +13,52 @@ TcpServerConfig::TcpServerConfig(TracePath &tracePath, const nlohmann::json::val
   }
 
   port = ExtractIpPort(tracePath, obj);
+
+  const auto shardsOpt = ExtractUnsignedNumberOpt<size_t>(tracePath, obj, keys::shards);
+  if (shardsOpt.has_value()) {
+    shards = shardsOpt.value();
+  }
+
+  const auto maxInflightOpt = ExtractUnsignedNumberOpt<size_t>(tracePath, obj, keys::maxInflight);
+  if (maxInflightOpt.has_value()) {
+    if (0 == maxInflightOpt.value()) {
+      TraceDeep td(tracePath, keys::maxInflight);
+      throw InvalidValueException(td, std::to_string(maxInflightOpt.value()));
+    }
+    CheckProfileLimit(tracePath, keys::maxInflight, maxInflightOpt.value(), profile::maxInflight);
+    maxInflight = maxInflightOpt.value();
+  }
+
+  const auto maxConnectionsOpt = ExtractUnsignedNumberOpt<size_t>(tracePath, obj, keys::maxConnections);
+  if (maxConnectionsOpt.has_value()) {
+    if (0 == maxConnectionsOpt.value()) {
+      TraceDeep td(tracePath, keys::maxConnections);
+      throw InvalidValueException(td, std::to_string(maxConnectionsOpt.value()));
+    }
+    CheckProfileLimit(tracePath, keys::maxConnections, maxConnectionsOpt.value(), profile::maxConnections);
+    connectionLimits.maxConnections = maxConnectionsOpt.value();
+  }
+
+  const auto maxConnectionsPerIpOpt = ExtractUnsignedNumberOpt<size_t>(tracePath, obj, keys::maxConnectionsPerIp);
+  if (maxConnectionsPerIpOpt.has_value()) {
+    if (0 == maxConnectionsPerIpOpt.value()) {
+      TraceDeep td(tracePath, keys::maxConnectionsPerIp);
+      throw InvalidValueException(td, std::to_string(maxConnectionsPerIpOpt.value()));
+    }
+    connectionLimits.maxConnectionsPerIp = maxConnectionsPerIpOpt.value();
+  }
+
+  const auto idleTimeoutOpt = ExtractUnsignedNumberOpt<size_t>(tracePath, obj, keys::idleTimeout);
+  if (idleTimeoutOpt.has_value()) {
+    connectionLimits.idleTimeout = std::chrono::milliseconds(idleTimeoutOpt.value());
+  }
+
+  const auto evictIdleOpt = ExtractValueOpt<bool>(tracePath, obj, keys::evictIdle, ValueType::Boolean);
+  if (evictIdleOpt.has_value()) {
+    connectionLimits.evictIdle = evictIdleOpt.value();
+  }
+
+  socketOptions = ExtractSocketOptions(tracePath, obj);
 }
 
 }// namespace modbus_gateway
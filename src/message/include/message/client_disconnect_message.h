@@ -1,5 +1,7 @@
 #pragma once
 
+#include <message/message_kind.h>
+
 #include <exchange/id.h>
 #include <exchange/message_helper.h>
 
@@ -8,6 +10,8 @@ namespace modbus_gateway {
 class ClientDisconnectMessage
     : public exchange::MessageHelper<ClientDisconnectMessage> {
 public:
+  static constexpr MessageKind kind = MessageKind::ClientDisconnect;
+
   explicit ClientDisconnectMessage(exchange::ActorId clientId);
 
   exchange::ActorId GetClientId() const;
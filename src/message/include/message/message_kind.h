@@ -0,0 +1,27 @@
+#pragma once
+
+#include <exchange/imessage.h>
+
+#include <memory>
+
+namespace modbus_gateway {
+
+enum class MessageKind {
+  Unknown,
+  Modbus,
+  ClientDisconnect,
+};
+
+// Message type is compared with known types exactly, without walk over class hierarchy
+MessageKind GetMessageKind(const exchange::IMessage &message);
+
+// Return nullptr if message has other kind, T must have static member kind
+template<typename T>
+std::shared_ptr<T> MessageCast(const exchange::MessagePtr &message) {
+  if (!message || T::kind != GetMessageKind(*message)) {
+    return nullptr;
+  }
+  return std::static_pointer_cast<T>(message);
+}
+
+}// namespace modbus_gateway
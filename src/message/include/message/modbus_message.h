@@ -1,6 +1,10 @@
 #pragma once
 
+#include <common/memory_budget.h>
+#include <common/pool_allocator.h>
+#include <common/profile.h>
 #include <common/types_modbus.h>
+#include <message/message_kind.h>
 #include <message/modbus_message_info.h>
 
 #include <exchange/message_helper.h>
@@ -10,6 +14,8 @@ namespace modbus_gateway {
 class ModbusMessage
     : public exchange::MessageHelper<ModbusMessage> {
 public:
+  static constexpr MessageKind kind = MessageKind::Modbus;
+
   ModbusMessage(const ModbusMessageInfo &modbusMessageInfo, const ModbusBufferPtr &modbusBuffer);
 
   ~ModbusMessage() override = default;
@@ -18,11 +24,27 @@ public:
 
   const ModbusBufferPtr &GetModbusBuffer() const;
 
+  // Memory of request is charged to source budget until message is released, call before send
+  void SetMemoryCharge(MemoryCharge &&memoryCharge);
+
 private:
   ModbusMessageInfo modbusMessageInfo_;
   ModbusBufferPtr modbusBuffer_;
+  MemoryCharge memoryCharge_;
 };
 
 using ModbusMessagePtr = std::shared_ptr<ModbusMessage>;
 
+struct ModbusMessagePoolTag {};
+
+using ModbusMessageAllocator = PoolAllocator<ModbusMessage, ModbusMessagePoolTag, profile::poolCacheSize>;
+
+// Message is returned to pool of thread which allocated it, also when last reference is released on other thread
+ModbusMessagePtr MakeModbusMessage(const ModbusMessageInfo &modbusMessageInfo, const ModbusBufferPtr &modbusBuffer);
+
+PoolStats GetModbusMessagePoolStats();
+
+// Fill pool of current thread, next messages of this thread are taken without heap allocation
+void ReserveModbusMessages(size_t count);
+
 }// namespace modbus_gateway
@@ -22,6 +22,9 @@ public:
 
   modbus::TransactionId GetTransactionId() const;
 
+  // Steady clock time of request creation, deadline of request is counted from it
+  std::chrono::nanoseconds GetCreateTimestamp() const;
+
 private:
   static std::chrono::nanoseconds GetCurrentTimestamp();
 
@@ -0,0 +1,21 @@
+#include <message/message_kind.h>
+
+#include <message/client_disconnect_message.h>
+#include <message/modbus_message.h>
+
+#include <typeinfo>
+
+namespace modbus_gateway {
+
+MessageKind GetMessageKind(const exchange::IMessage &message) {
+  const std::type_info &type = typeid(message);
+  if (typeid(ModbusMessage) == type) {
+    return MessageKind::Modbus;
+  }
+  if (typeid(ClientDisconnectMessage) == type) {
+    return MessageKind::ClientDisconnect;
+  }
+  return MessageKind::Unknown;
+}
+
+}// namespace modbus_gateway
@@ -1,9 +1,11 @@
 #include <message/modbus_message.h>
 
+#include <vector>
+
 namespace modbus_gateway {
 
 ModbusMessage::ModbusMessage(const ModbusMessageInfo &modbusMessageInfo, const ModbusBufferPtr &modbusBuffer)
-    : modbusMessageInfo_(modbusMessageInfo), modbusBuffer_(modbusBuffer) {}
+    : modbusMessageInfo_(modbusMessageInfo), modbusBuffer_(modbusBuffer), memoryCharge_() {}
 
 const ModbusMessageInfo &ModbusMessage::GetModbusMessageInfo() const {
   return modbusMessageInfo_;
@@ -13,4 +15,25 @@ const ModbusBufferPtr &ModbusMessage::GetModbusBuffer() const {
   return modbusBuffer_;
 }
 
+void ModbusMessage::SetMemoryCharge(MemoryCharge &&memoryCharge) {
+  memoryCharge_ = std::move(memoryCharge);
+}
+
+ModbusMessagePtr MakeModbusMessage(const ModbusMessageInfo &modbusMessageInfo, const ModbusBufferPtr &modbusBuffer) {
+  return std::allocate_shared<ModbusMessage>(ModbusMessageAllocator(), modbusMessageInfo, modbusBuffer);
+}
+
+PoolStats GetModbusMessagePoolStats() {
+  return PoolCounters<ModbusMessagePoolTag>::Get();
+}
+
+void ReserveModbusMessages(size_t count) {
+  // blocks return to free list of this thread on release
+  std::vector<ModbusMessagePtr> messages;
+  messages.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    messages.push_back(MakeModbusMessage(ModbusMessageInfo(exchange::defaultId, 0), nullptr));
+  }
+}
+
 }// namespace modbus_gateway
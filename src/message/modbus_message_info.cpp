@@ -26,6 +26,10 @@ modbus::TransactionId ModbusMessageInfo::GetTransactionId() const {
   return transactionId_;
 }
 
+std::chrono::nanoseconds ModbusMessageInfo::GetCreateTimestamp() const {
+  return createTimeStamp_;
+}
+
 std::chrono::nanoseconds ModbusMessageInfo::GetCurrentTimestamp() {
   return TargetClock::now().time_since_epoch();
 }
@@ -1,6 +1,14 @@
 #include <modbus_gateway.h>
 
+#include <common/context_group.h>
+#include <common/memory_budget.h>
+#include <common/profile.h>
+#include <common/realtime.h>
+#include <common/timer_wheel.h>
 #include <common/types_asio.h>
+#include <common/types_modbus.h>
+
+#include <message/modbus_message.h>
 
 #include <transport/i_modbus_slave.h>
 #include <transport/modbus_rtu_master.h>
@@ -8,6 +16,7 @@
 #include <transport/modbus_tcp_client.h>
 #include <transport/modbus_tcp_server.h>
 #include <transport/router.h>
+#include <transport/socket_options.h>
 
 #include <config/master_config.h>
 #include <config/rtu_maser_config.h>
@@ -20,8 +29,16 @@
 #include <exchange/exchange.h>
 #include <exchange/iactor.h>
 
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+
 namespace modbus_gateway {
 
+// Resolution and size of timer wheel for transaction deadlines
+static constexpr auto timerWheelTick = std::chrono::milliseconds(1);
+static constexpr size_t timerWheelSlots = 1024;
+
 struct Master {
   TransportConfigPtr config;
   exchange::ActorPtr actor;
@@ -32,7 +49,143 @@ struct Slave {
   ModbusSlavePtr Slave;
 };
 
-std::vector<Master> MakeMasters(const std::vector<TransportConfigPtr> &mastersConfig, const exchange::ExchangePtr &exchange, const ContextPtr &context) {
+// Select context for transport: network transports use shared pool,
+// rtu transports may use own context for keep bus timings
+class Contexts {
+public:
+  Contexts(ContextGroup &contextGroup, const ConfigService &configService)
+      : contextGroup_(contextGroup),
+        rtuContextMode_(configService.rtuContext),
+        networkOptions_(MakeThreadOptions(configService, false)),
+        rtuOptions_(MakeThreadOptions(configService, true)),
+        network_(contextGroup.Add(configService.threads, networkOptions_)),
+        rtu_(nullptr),
+        devices_(),
+        shards_(),
+        timerWheels_() {}
+
+  const ContextPtr &GetNetwork() const {
+    return network_;
+  }
+
+  const ContextPtr &GetRtu(const std::string &device) {
+    switch (rtuContextMode_) {
+    case RtuContextMode::Shared:
+      return network_;
+    case RtuContextMode::Dedicated:
+      if (!rtu_) {
+        rtu_ = contextGroup_.Add(1, rtuOptions_);
+        MG_INFO("MG::Contexts: create dedicated rtu context");
+      }
+      return rtu_;
+    case RtuContextMode::PerDevice: {
+      auto &context = devices_[device];
+      if (!context) {
+        context = contextGroup_.Add(1, rtuOptions_);
+        MG_INFO("MG::Contexts: create rtu context for device {}", device);
+      }
+      return context;
+    }
+    default:
+      throw std::logic_error("BUG! unknown rtu context mode");
+    }
+  }
+
+  // Shard contexts are shared between tcp servers, every shard has one thread pinned to own cpu
+  std::vector<ContextPtr> GetShards(size_t shards) {
+    if (0 == shards) {
+      return {network_};
+    }
+    const size_t cpuCount = GetCpuCount();
+    while (shards_.size() < shards) {
+      ThreadOptions shardOptions = networkOptions_;
+      const size_t cpu = networkOptions_.cpus.empty()
+                             ? shards_.size() % cpuCount
+                             : networkOptions_.cpus[shards_.size() % networkOptions_.cpus.size()];
+      shardOptions.cpus = {cpu};
+      shards_.push_back(contextGroup_.Add(1, shardOptions));
+      MG_INFO("MG::Contexts: create shard context {} on cpu {}", shards_.size() - 1, cpu);
+    }
+    return {shards_.begin(), shards_.begin() + static_cast<std::ptrdiff_t>(shards)};
+  }
+
+  // Every context has own timer wheel, deadlines of master are ticked by threads of master context
+  const TimerWheelPtr &GetTimerWheel(const ContextPtr &context) {
+    auto &timerWheel = timerWheels_[context.get()];
+    if (!timerWheel) {
+      timerWheel = std::make_shared<TimerWheel>(context, timerWheelTick, timerWheelSlots);
+    }
+    return timerWheel;
+  }
+
+private:
+  static ThreadOptions MakeThreadOptions(const ConfigService &configService, bool rtu) {
+    ThreadOptions threadOptions;
+    const auto &busyPoll = configService.busyPoll;
+    if (busyPoll.has_value()) {
+      threadOptions.busyPoll = rtu ? busyPoll->rtu : busyPoll->network;
+    }
+    const auto &realtime = configService.realtime;
+    if (realtime.has_value()) {
+      threadOptions.cpus = rtu ? realtime->rtuCpuAffinity : realtime->cpuAffinity;
+      threadOptions.policy = realtime->policy;
+      threadOptions.priority = rtu ? realtime->rtuPriority : realtime->priority;
+      threadOptions.prefaultStack = realtime->prefaultStack;
+      threadOptions.prefaultHeap = realtime->prefaultHeap;
+    }
+    return threadOptions;
+  }
+
+private:
+  ContextGroup &contextGroup_;
+  RtuContextMode rtuContextMode_;
+  ThreadOptions networkOptions_;
+  ThreadOptions rtuOptions_;
+  ContextPtr network_;
+  ContextPtr rtu_;
+  std::unordered_map<std::string, ContextPtr> devices_;
+  std::vector<ContextPtr> shards_;
+  std::unordered_map<ContextPtr::element_type *, TimerWheelPtr> timerWheels_;
+};
+
+// Options of transport take precedence, service options fill the rest
+SocketOptions MergeSocketOptions(SocketOptions options, const SocketOptions &defaultOptions) {
+  if (!options.busyPoll.has_value()) {
+    options.busyPoll = defaultOptions.busyPoll;
+  }
+  return options;
+}
+
+// Serial transports are specialized by frame type, specialization is selected by frame type from config
+template<typename RtuMaster>
+std::shared_ptr<RtuMaster> MakeRtuMaster(const RtuMasterConfig &config, const exchange::ExchangePtr &exchange, Contexts &contexts,
+                                         Delivery delivery) {
+  const ContextPtr &context = contexts.GetRtu(config.device);
+  auto rtuMaster = RtuMaster::Create(exchange,
+                                     context,
+                                     contexts.GetTimerWheel(context),
+                                     config.device,
+                                     config.rtuOptions,
+                                     config.timeout);
+  rtuMaster->SetDelivery(delivery);
+  rtuMaster->SetQueue(config.queueSize, config.dropPolicy);
+  return rtuMaster;
+}
+
+template<typename RtuSlave>
+std::shared_ptr<RtuSlave> MakeRtuSlave(const RtuSlaveConfig &config, const exchange::ExchangePtr &exchange, Contexts &contexts,
+                                       const RouterPtr &router, Delivery delivery) {
+  auto rtuSlave = RtuSlave::Create(exchange,
+                                   contexts.GetRtu(config.device),
+                                   config.device,
+                                   config.rtuOptions,
+                                   router);
+  rtuSlave->SetDelivery(delivery);
+  return rtuSlave;
+}
+
+std::vector<Master> MakeMasters(const std::vector<TransportConfigPtr> &mastersConfig, const exchange::ExchangePtr &exchange, Contexts &contexts,
+                                const SocketOptions &defaultSocketOptions, Delivery delivery) {
 
   std::vector<Master> masters;
   masters.reserve(mastersConfig.size());
@@ -45,13 +198,18 @@ std::vector<Master> MakeMasters(const std::vector<TransportConfigPtr> &mastersCo
         throw std::logic_error("BUG! cast to TcpClientConfig failed");
       }
       auto tcpClient = ModbusTcpClient::Create(exchange,
-                                               context,
+                                               contexts.GetNetwork(),
+                                               contexts.GetTimerWheel(contexts.GetNetwork()),
                                                tcpClientConfig->address,
                                                tcpClientConfig->port,
-                                               tcpClientConfig->timeout);
+                                               tcpClientConfig->timeout,
+                                               MergeSocketOptions(tcpClientConfig->socketOptions, defaultSocketOptions));
+      tcpClient->SetDelivery(delivery);
+      tcpClient->SetQueue(tcpClientConfig->queueSize, tcpClientConfig->dropPolicy);
       const auto actorId = exchange->Add(tcpClient);
-      MG_INFO("MG::MakeMasters: Create modbus tcp client; address {}, port {}, timeout {}, actor id {}",
-               tcpClientConfig->address.to_string(), tcpClientConfig->port, tcpClientConfig->timeout.count(), actorId);
+      MG_INFO("MG::MakeMasters: Create modbus tcp client; address {}, port {}, timeout {}, queue size {}, actor id {}",
+               tcpClientConfig->address.to_string(), tcpClientConfig->port, tcpClientConfig->timeout.count(),
+               tcpClientConfig->queueSize, actorId);
 
       Master client = {tcpClientConfig, tcpClient};
       if (tcpClientConfig->unitIdSet.empty()) {
@@ -65,15 +223,21 @@ std::vector<Master> MakeMasters(const std::vector<TransportConfigPtr> &mastersCo
       if (!rtuMasterConfig) {
         throw std::logic_error("BUG! cast to TcpClientConfig failed");
       }
-      auto rtuMaster = ModbusRtuMaster::Create(exchange,
-                                               context,
-                                               rtuMasterConfig->device,
-                                               rtuMasterConfig->rtuOptions,
-                                               rtuMasterConfig->timeout,
-                                               rtuMasterConfig->GetFrameType());
+      exchange::ActorPtr rtuMaster = nullptr;
+      switch (rtuMasterConfig->GetFrameType()) {
+      case modbus::FrameType::RTU:
+        rtuMaster = MakeRtuMaster<ModbusRtuMaster>(*rtuMasterConfig, exchange, contexts, delivery);
+        break;
+      case modbus::FrameType::ASCII:
+        rtuMaster = MakeRtuMaster<ModbusAsciiMaster>(*rtuMasterConfig, exchange, contexts, delivery);
+        break;
+      default:
+        throw std::logic_error("BUG! invalid rtu master frame type");
+      }
       const auto actorId = exchange->Add(rtuMaster);
-      MG_INFO("MG::MakeMasters: create modbus rtu master; device {}, timeout {}, frame type {} actor id {}",
-               rtuMasterConfig->device, rtuMasterConfig->timeout.count(), rtuMasterConfig->GetFrameType(), actorId);
+      MG_INFO("MG::MakeMasters: create modbus rtu master; device {}, timeout {}, queue size {}, frame type {} actor id {}",
+               rtuMasterConfig->device, rtuMasterConfig->timeout.count(), rtuMasterConfig->queueSize,
+               rtuMasterConfig->GetFrameType(), actorId);
 
       Master client = {rtuMasterConfig, rtuMaster};
       if (rtuMasterConfig->unitIdSet.empty()) {
@@ -90,6 +254,19 @@ std::vector<Master> MakeMasters(const std::vector<TransportConfigPtr> &mastersCo
   return masters;
 }
 
+// Longest time master holds request: wait in queue and transaction, each is limited by timeout of master
+std::chrono::milliseconds MaxRequestLifetime(const std::vector<Master> &masters) {
+  std::chrono::milliseconds timeout(0);
+  for (const auto &master : masters) {
+    const auto &masterConfig = std::dynamic_pointer_cast<MasterConfig>(master.config);
+    if (!masterConfig) {
+      throw std::logic_error("BUG! cast to MasterConfig failed");
+    }
+    timeout = std::max(timeout, masterConfig->timeout);
+  }
+  return 2 * timeout;
+}
+
 RouterPtr MakeRouter(const std::vector<Master> &masters) {
   std::shared_ptr<Router> router = nullptr;
 
@@ -134,10 +311,21 @@ RouterPtr MakeRouter(const std::vector<Master> &masters) {
   return router;
 }
 
-std::vector<Slave> MakeSlaves(const std::vector<TransportConfigPtr> &slavesConfigs, const exchange::ExchangePtr &exchange, const ContextPtr &context, const RouterPtr &router) {
+std::vector<Slave> MakeSlaves(const std::vector<TransportConfigPtr> &slavesConfigs, const exchange::ExchangePtr &exchange, Contexts &contexts,
+                              const RouterPtr &router, const SocketOptions &defaultSocketOptions, Delivery delivery,
+                              const std::optional<MemoryBudgetOptions> &memoryBudgetOptions,
+                              std::chrono::milliseconds inflightTimeout) {
   std::vector<Slave> slaves;
   slaves.reserve(slavesConfigs.size());
 
+  // connections of all servers share global budget
+  MemoryBudgetPtr memoryBudget = nullptr;
+  if (memoryBudgetOptions.has_value()) {
+    memoryBudget = std::make_shared<MemoryBudget>(memoryBudgetOptions->global);
+    MG_INFO("MG::MakeSlaves: memory budget global {} bytes, connection {} bytes", memoryBudgetOptions->global,
+            memoryBudgetOptions->connection);
+  }
+
   for (const auto &slavesConfig : slavesConfigs) {
     switch (slavesConfig->GetType()) {
     case TransportType::TcpServer: {
@@ -146,13 +334,22 @@ std::vector<Slave> MakeSlaves(const std::vector<TransportConfigPtr> &slavesConfi
         throw std::logic_error("BUG! cast to TcpServerConfig failed");
       }
       std::shared_ptr<ModbusTcpServer> tcpServer = ModbusTcpServer::Create(exchange,
-                                                                           context,
+                                                                           contexts.GetShards(tcpServerConfig->shards),
                                                                            tcpServerConfig->address,
                                                                            tcpServerConfig->port,
-                                                                           router);
+                                                                           router,
+                                                                           MergeSocketOptions(tcpServerConfig->socketOptions, defaultSocketOptions));
+      tcpServer->SetDelivery(delivery);
+      tcpServer->SetMaxInflight(tcpServerConfig->maxInflight);
+      tcpServer->SetInflightTimeout(inflightTimeout);
+      tcpServer->SetConnectionLimits(tcpServerConfig->connectionLimits);
+      if (memoryBudget) {
+        tcpServer->SetMemoryBudget(memoryBudget, memoryBudgetOptions->connection);
+      }
       const exchange::ActorId id = exchange->Add(tcpServer);
-      MG_INFO("MG::MakeSlaves: create modbus tcp server address {}, port {}, actor id {}",
-               tcpServerConfig->address.to_string(), tcpServerConfig->port, id);
+      MG_INFO("MG::MakeSlaves: create modbus tcp server address {}, port {}, shards {}, max inflight {}, actor id {}",
+               tcpServerConfig->address.to_string(), tcpServerConfig->port, tcpServerConfig->shards,
+               tcpServerConfig->maxInflight, id);
       Slave server = {tcpServerConfig, tcpServer};
       slaves.push_back(server);
     } break;
@@ -161,13 +358,23 @@ std::vector<Slave> MakeSlaves(const std::vector<TransportConfigPtr> &slavesConfi
       if (!rtuSlaveConfig) {
         throw std::logic_error("BUG! cast to TcpServerConfig failed");
       }
-      std::shared_ptr<ModbusRtuSlave> rtuSlave = ModbusRtuSlave::Create(exchange,
-                                                                        context,
-                                                                        rtuSlaveConfig->device,
-                                                                        rtuSlaveConfig->rtuOptions,
-                                                                        router,
-                                                                        rtuSlaveConfig->GetFrameType());
-      const exchange::ActorId id = exchange->Add(rtuSlave);
+      exchange::ActorPtr actor = nullptr;
+      ModbusSlavePtr rtuSlave = nullptr;
+      switch (rtuSlaveConfig->GetFrameType()) {
+      case modbus::FrameType::RTU: {
+        auto slave = MakeRtuSlave<ModbusRtuSlave>(*rtuSlaveConfig, exchange, contexts, router, delivery);
+        actor = slave;
+        rtuSlave = slave;
+      } break;
+      case modbus::FrameType::ASCII: {
+        auto slave = MakeRtuSlave<ModbusAsciiSlave>(*rtuSlaveConfig, exchange, contexts, router, delivery);
+        actor = slave;
+        rtuSlave = slave;
+      } break;
+      default:
+        throw std::logic_error("BUG! invalid rtu slave frame type");
+      }
+      const exchange::ActorId id = exchange->Add(actor);
       MG_INFO("MG::MakeSlaves: create modbus rtu slave device {}, frame type {}, actor id {}",
                rtuSlaveConfig->device, rtuSlaveConfig->GetFrameType(), id);
       Slave server = {rtuSlaveConfig, rtuSlave};
@@ -186,15 +393,35 @@ int ModbusGateway(const Config &config) {
   Logger::SetLogLevel(config.configService.logLevel);
   MG_INFO("MG: loglevel {}", config.configService.logLevel);
 
+  const auto &realtime = config.configService.realtime;
+  if (realtime.has_value()) {
+    MG_INFO("MG: realtime policy {}, priority {}, rtu priority {}, cpus {}, rtu cpus {}, mlockall {}",
+            static_cast<int>(realtime->policy), realtime->priority, realtime->rtuPriority,
+            realtime->cpuAffinity.size(), realtime->rtuCpuAffinity.size(), realtime->lockMemory);
+    if (realtime->lockMemory) {
+      LockMemory();
+    }
+    if (realtime->prefaultHeap > 0) {
+      PrefaultHeap(realtime->prefaultHeap);
+    }
+  }
+
   auto idGenerator = std::make_shared<exchange::IdGeneratorReuse>();
   auto actorStorage = std::make_unique<exchange::ActorStorageTable>();
   auto exchange = std::make_shared<exchange::Exchange>(std::move(actorStorage), idGenerator);
 
-  ContextPtr context = std::make_shared<ContextPtr::element_type>(config.configService.threads);
+  ContextGroup contextGroup;
+  if (profile::poolPreallocate > 0) {
+    // pools are per thread, every worker fills own pools before first transaction
+    contextGroup.SetStartHandler([]() {
+      ReserveModbusBuffers(profile::poolPreallocate);
+      ReserveModbusMessages(profile::poolPreallocate);
+    });
+  }
+  Contexts contexts(contextGroup, config.configService);
   MG_INFO("MG: threads {}", config.configService.threads);
-  auto work = asio::executor_work_guard(context->get_executor());
 
-  asio::signal_set signalSet(*context);
+  asio::signal_set signalSet(*contexts.GetNetwork());
   signalSet.add(SIGINT);
   signalSet.add(SIGILL);
   signalSet.add(SIGABRT);
@@ -202,16 +429,22 @@ int ModbusGateway(const Config &config) {
   signalSet.add(SIGSEGV);
   signalSet.add(SIGTERM);
 
-  signalSet.async_wait([context](const asio::error_code &ec, int signalNumber) {
+  signalSet.async_wait([&contextGroup](const asio::error_code &ec, int signalNumber) {
     if (ec) {
       MG_ERROR("SignalSet::wait: error: {}", ec.message());
       return;
     }
     MG_INFO("SignalSet::wait: signal {}", signalNumber);
-    context->stop();
+    contextGroup.Stop();
   });
 
-  std::vector<Master> masters = MakeMasters(config.masters, exchange, context);
+  SocketOptions socketOptions;
+  if (config.configService.busyPoll.has_value()) {
+    socketOptions.busyPoll = config.configService.busyPoll->socket;
+  }
+
+  std::vector<Master> masters = MakeMasters(config.masters, exchange, contexts, socketOptions,
+                                            config.configService.delivery);
   if (masters.empty()) {
     throw std::logic_error("BUG! masters is empty");
   }
@@ -221,7 +454,8 @@ int ModbusGateway(const Config &config) {
     throw std::logic_error("BUG! router is null");
   }
 
-  std::vector<Slave> slaves = MakeSlaves(config.slaves, exchange, context, router);
+  std::vector<Slave> slaves = MakeSlaves(config.slaves, exchange, contexts, router, socketOptions, config.configService.delivery,
+                                         config.configService.memoryBudget, MaxRequestLifetime(masters));
   if (slaves.empty()) {
     throw std::logic_error("BUG! slaves is empty");
   }
@@ -231,10 +465,27 @@ int ModbusGateway(const Config &config) {
     slave.Slave->Start();
   }
 
-  MG_INFO("MG: starting")
-  context->run();
+  MG_INFO("MG: starting, contexts {}, embedded profile {}, resident memory {} kB", contextGroup.Size(), profile::embedded,
+          GetResidentMemory() / 1024)
+  contextGroup.Run();
+  contextGroup.Join();
   MG_INFO("MG: stopping")
 
+  const auto bufferPoolStats = GetModbusBufferPoolStats();
+  MG_INFO("MG: buffer pool hits {}, misses {}", bufferPoolStats.hits, bufferPoolStats.misses);
+  const auto messagePoolStats = GetModbusMessagePoolStats();
+  MG_INFO("MG: message pool hits {}, misses {}", messagePoolStats.hits, messagePoolStats.misses);
+  MG_INFO("MG: resident memory {} kB, peak {} kB", GetResidentMemory() / 1024, GetPeakResidentMemory() / 1024);
+
+  for (auto &slave : slaves) {
+    if (TransportType::TcpServer == slave.Slave->GetType()) {
+      const auto stats = std::static_pointer_cast<ModbusTcpServer>(slave.Slave)->GetConnectionStats();
+      MG_INFO("MG: tcp server connections accepted {}, rejected {}, reaped {}, evicted {}", stats.accepted,
+              stats.rejected, stats.reaped, stats.evicted);
+    }
+    slave.Slave->Stop();
+  }
+
   return EXIT_SUCCESS;
 }
 
@@ -0,0 +1,17 @@
+#include <transport/frame_converter.h>
+
+namespace modbus_gateway {
+
+bool ConvertFrame(modbus::ModbusBuffer &modbusBuffer, modbus::FrameType frameType) {
+  switch (frameType) {
+  case modbus::FrameType::TCP:
+    return ConvertFrame<modbus::FrameType::TCP>(modbusBuffer);
+  case modbus::FrameType::RTU:
+    return ConvertFrame<modbus::FrameType::RTU>(modbusBuffer);
+  case modbus::FrameType::ASCII:
+    return ConvertFrame<modbus::FrameType::ASCII>(modbusBuffer);
+  }
+  return false;
+}
+
+}// namespace modbus_gateway
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <common/profile.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace modbus_gateway {
+
+struct ConnectionLimits {
+  size_t maxConnections = profile::maxConnections;
+  size_t maxConnectionsPerIp = std::numeric_limits<size_t>::max();
+  std::chrono::milliseconds idleTimeout{0};// 0 - connection is not reaped
+  bool evictIdle = false;// full server closes least recently active connection instead of new one
+};
+
+// Connections which were not served or were closed by server
+struct ConnectionStats {
+  uint64_t accepted = 0;
+  uint64_t rejected = 0;
+  uint64_t reaped = 0;
+  uint64_t evicted = 0;
+};
+
+}// namespace modbus_gateway
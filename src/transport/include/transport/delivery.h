@@ -0,0 +1,23 @@
+#pragma once
+
+#include <common/types_asio.h>
+
+#include <utility>
+
+namespace modbus_gateway {
+
+enum class Delivery {
+  Post,// handler is queued to actor executor, sender never runs receiver code
+  Inline,// handler may run in sender thread if actor executor is free, for actors on same context
+};
+
+template<typename Executor, typename Handler>
+void Deliver(Delivery delivery, const Executor &executor, Handler &&handler) {
+  if (Delivery::Inline == delivery) {
+    asio::dispatch(executor, std::forward<Handler>(handler));
+    return;
+  }
+  asio::post(executor, std::forward<Handler>(handler));
+}
+
+}// namespace modbus_gateway
@@ -0,0 +1,11 @@
+#pragma once
+
+namespace modbus_gateway {
+
+// Which request is dropped when master queue is full
+enum class DropPolicy {
+  DropOldest,// request queued first
+  RejectNewest,// incoming request, queued requests are kept
+};
+
+}// namespace modbus_gateway
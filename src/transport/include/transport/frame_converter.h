@@ -0,0 +1,34 @@
+#pragma once
+
+#include <transport/frame_traits.h>
+
+#include <modbus/modbus_buffer.h>
+
+namespace modbus_gateway {
+
+// Convert buffer to frame type in place. Header and checksum are rebuilt only when frame type is changed,
+// frame of same type was checked on receive and it is sent as is. Return true if buffer was converted.
+// Adu always starts at begin of buffer, layout of buffer is owned by modbus library: tcp<->rtu conversion
+// moves pdu by difference of headers and ascii is encoded inside buffer, there is no headroom to rewrite header only
+template<modbus::FrameType frameType>
+bool ConvertFrame(modbus::ModbusBuffer &modbusBuffer) {
+  if (modbusBuffer.GetType() == frameType) {
+    return false;
+  }
+
+  modbusBuffer.ConvertTo(frameType);
+  typename FrameTraits<frameType>::Wrapper wrapper(modbusBuffer);
+  wrapper.Update();
+  return true;
+}
+
+bool ConvertFrame(modbus::ModbusBuffer &modbusBuffer, modbus::FrameType frameType);
+
+// Check crc or lrc of received frame
+template<modbus::FrameType frameType>
+modbus::CheckFrameResult CheckFrame(modbus::ModbusBuffer &modbusBuffer) {
+  const typename FrameTraits<frameType>::Wrapper wrapper(modbusBuffer);
+  return wrapper.Check();
+}
+
+}// namespace modbus_gateway
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <modbus/modbus_buffer_ascii_wrapper.h>
+#include <modbus/modbus_buffer_rtu_wrapper.h>
+#include <modbus/modbus_buffer_tcp_wrapper.h>
+#include <modbus/modbus_types.h>
+
+namespace modbus_gateway {
+
+// Buffer wrapper of frame type known at compile time, it lives on stack and its check and update are not virtual
+template<modbus::FrameType frameType>
+struct FrameTraits;
+
+template<>
+struct FrameTraits<modbus::FrameType::TCP> {
+  using Wrapper = modbus::ModbusBufferTcpWrapper;
+};
+
+template<>
+struct FrameTraits<modbus::FrameType::RTU> {
+  using Wrapper = modbus::ModbusBufferRtuWrapper;
+};
+
+template<>
+struct FrameTraits<modbus::FrameType::ASCII> {
+  using Wrapper = modbus::ModbusBufferAsciiWrapper;
+};
+
+}// namespace modbus_gateway
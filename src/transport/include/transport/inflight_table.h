@@ -0,0 +1,49 @@
+#pragma once
+
+#include <modbus/modbus_types.h>
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace modbus_gateway {
+
+// Transactions of one tcp client waiting for response. Depth is small, slots are contiguous and searched linearly.
+// Slot is freed when response is sent or when timeout is reached, request which is never answered (not routed,
+// lost by master) does not hold slot forever
+class InflightTable {
+  using Clock = std::chrono::steady_clock;
+
+  struct Inflight {
+    modbus::TransactionId id;
+    Clock::time_point expire;
+  };
+
+public:
+  // Twice default timeout of master: request waits in queue of master, then in transaction
+  static constexpr std::chrono::milliseconds defaultTimeout{2000};
+
+  InflightTable(size_t depth, std::chrono::milliseconds timeout);
+
+  // Return false if table is full or transaction with same id is in flight
+  bool Insert(modbus::TransactionId id);
+
+  // Return false if transaction is not in flight
+  bool Erase(modbus::TransactionId id);
+
+  size_t Size() const;
+
+  size_t Depth() const;
+
+  std::chrono::milliseconds Timeout() const;
+
+private:
+  void RemoveExpired(Clock::time_point now);
+
+private:
+  std::vector<Inflight> inflight_;
+  size_t depth_;
+  std::chrono::milliseconds timeout_;
+};
+
+}// namespace modbus_gateway
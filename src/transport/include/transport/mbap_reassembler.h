@@ -0,0 +1,53 @@
+#pragma once
+
+#include <common/types_asio.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace modbus_gateway {
+
+// Incremental decoder of modbus tcp stream. Received bytes are kept in ring, adu is cut by length field
+// of MBAP header, so request may be split over segments and one segment may carry several requests
+class MbapReassembler {
+public:
+  enum class Result {
+    Complete,// adu is received, size is known
+    NeedMore,// header or body is not received yet
+    Invalid,// header is broken, stream is out of sync
+  };
+
+  // transaction id, protocol id, length, unit id
+  static constexpr size_t headerSize = 7;
+  static constexpr size_t maxAduSize = 260;
+
+  // Capacity is not less than max adu size
+  explicit MbapReassembler(size_t capacity);
+
+  // Free contiguous space after received bytes, next receive goes there
+  asio::mutable_buffer Prepare();
+
+  void Commit(size_t size);
+
+  // Check next adu in received bytes
+  Result Next(size_t &aduSize) const;
+
+  // Copy next adu and remove it from ring, size is taken from Next
+  void Take(uint8_t *adu, size_t aduSize);
+
+  // Drop all received bytes
+  void Reset();
+
+  size_t Size() const;
+
+private:
+  uint8_t At(size_t pos) const;
+
+private:
+  std::vector<uint8_t> ring_;
+  size_t head_;
+  size_t size_;
+};
+
+}// namespace modbus_gateway
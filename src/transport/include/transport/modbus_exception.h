@@ -0,0 +1,24 @@
+#pragma once
+
+#include <message/modbus_message.h>
+
+#include <exchange/iexchange.h>
+#include <modbus/modbus_buffer.h>
+
+#include <cstdint>
+
+namespace modbus_gateway {
+
+enum class ModbusExceptionCode : uint8_t {
+  ServerDeviceBusy = 0x06,
+  GatewayTargetFailed = 0x0B,
+};
+
+// Turn request into exception response in place. Buffer is converted to tcp frame,
+// transport converts response to own frame type as any other response
+void MakeExceptionResponse(modbus::ModbusBuffer &modbusBuffer, ModbusExceptionCode code);
+
+// Answer dropped request with exception response to its source. Return false if response is not delivered
+bool RejectRequest(const exchange::ExchangeWeak &exchange, const ModbusMessagePtr &message, ModbusExceptionCode code);
+
+}// namespace modbus_gateway
@@ -1,7 +1,14 @@
 #pragma once
 
+#include <common/handler_memory.h>
 #include <common/types_modbus.h>
-#include <common/limit_queue.h>
+#include <common/mpsc_mailbox.h>
+#include <common/profile.h>
+#include <common/timer_wheel.h>
+#include <transport/delivery.h>
+#include <transport/drop_policy.h>
+#include <transport/modbus_exception.h>
+#include <transport/request_queue.h>
 #include <transport/rtu_options.h>
 #include <message/modbus_message.h>
 
@@ -9,27 +16,41 @@
 #include <exchange/iexchange.h>
 
 #include <modbus/modbus_buffer.h>
+#include <modbus/modbus_types.h>
 
+#include <memory>
 #include <optional>
 
 namespace modbus_gateway {
 
-class ModbusRtuMaster : public exchange::ActorHelper<ModbusRtuMaster> {
+// Serial line master, frame type is template parameter and frame check is resolved at compile time
+template<modbus::FrameType frameType>
+class BasicModbusRtuMaster : public exchange::ActorHelper<BasicModbusRtuMaster<frameType>> {
+  static_assert(frameType != modbus::FrameType::TCP, "serial line frame type is rtu or ascii");
+
+  using Base = exchange::ActorHelper<BasicModbusRtuMaster<frameType>>;
 
   struct ModbusCurrentMessage {
     ModbusMessagePtr modbusMessage;
     modbus::TransactionId id;
   };
 
+  class TransactionOp;
+
+  static constexpr size_t mailboxCapacity = profile::mailboxCapacity;
+
 public:
-  ModbusRtuMaster(const exchange::ExchangePtr &exchange,
-                  const ContextPtr &context,
-                  const std::string &device,
-                  const RtuOptions &options,
-                  std::chrono::milliseconds timeout,
-                  modbus::FrameType frameType);
+  using typename Base::Ptr;
+  using typename Base::Weak;
 
-  ~ModbusRtuMaster() override;
+  BasicModbusRtuMaster(const exchange::ExchangePtr &exchange,
+                       const ContextPtr &context,
+                       const TimerWheelPtr &timerWheel,
+                       const std::string &device,
+                       const RtuOptions &options,
+                       std::chrono::milliseconds timeout);
+
+  ~BasicModbusRtuMaster() override;
 
   void Receive(const exchange::MessagePtr &message) override;
 
@@ -39,8 +60,14 @@ public:
 
   exchange::ActorId GetId() override;
 
+  // Call before start
+  void SetDelivery(Delivery delivery);
+
+  // Call before start, queue of constructor keeps profile::queueDepth requests and drops oldest
+  void SetQueue(size_t size, DropPolicy dropPolicy);
+
 private:
-  void MessageProcess(const ModbusMessagePtr &message);
+  void MailboxProcess();
 
   void QueueProcessUnsafe();
 
@@ -48,21 +75,37 @@ private:
 
   void StartWaitTask();
 
-  void StartReadTask();
+  void WaitComplete(modbus::TransactionId id);
+
+  // Answer request with exception, it is dropped from full mailbox or queue. Called by producer thread too
+  void RejectMessage(const ModbusMessagePtr &message, ModbusExceptionCode code);
+
+  // Slave did not answer current request, source gets exception instead of waiting for own timeout
+  void FailCurrentMessageUnsafe();
+
+  void ReadComplete(const ModbusBufferPtr &modbusBuffer, asio::error_code ec, size_t size);
 
   ModbusMessagePtr MakeResponse(const ModbusBufferPtr &modbusBuffer, size_t size);
 
 private:
   exchange::ActorId id_;
   exchange::ExchangeWeak exchange_;
-  asio::serial_port serialPort_;
+  StrandSerialPort serialPort_;
   std::chrono::milliseconds timeout_;
-  modbus::FrameType frameType_;
-  asio::basic_waitable_timer<std::chrono::steady_clock> timer_;
-  std::mutex m_;
-  LimitQueue<ModbusMessagePtr> messageQueue_;
+  TimerWheelPtr timerWheel_;
+  TimerWheel::Handle deadline_;
+  MpscMailbox<ModbusMessagePtr> mailbox_;
+  RequestQueue messageQueue_;
   std::optional<ModbusCurrentMessage> currentMessage_;
   modbus::TransactionId transactionIdGenerator_;
+  Delivery delivery_;
+  HandlerMemoryPtr transactionMemory_;
 };
 
+using ModbusRtuMaster = BasicModbusRtuMaster<modbus::FrameType::RTU>;
+using ModbusAsciiMaster = BasicModbusRtuMaster<modbus::FrameType::ASCII>;
+
+extern template class BasicModbusRtuMaster<modbus::FrameType::RTU>;
+extern template class BasicModbusRtuMaster<modbus::FrameType::ASCII>;
+
 }// namespace modbus_gateway
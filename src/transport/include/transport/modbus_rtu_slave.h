@@ -1,13 +1,15 @@
 #pragma once
 
-#include <common/synchronized.h>
+#include <common/handler_memory.h>
 #include <common/types_asio.h>
 #include <common/types_modbus.h>
 #include <message/modbus_message.h>
 #include <message/modbus_message_info.h>
+#include <transport/delivery.h>
 #include <transport/irouter.h>
 #include <transport/rtu_options.h>
 #include <transport/i_modbus_slave.h>
+#include <transport/write_queue.h>
 
 #include <exchange/actor_helper.h>
 #include <exchange/iexchange.h>
@@ -19,18 +21,27 @@
 
 namespace modbus_gateway {
 
-class ModbusRtuSlave : public exchange::ActorHelper<ModbusRtuSlave>, public IModbusSlave {
+// Serial line slave, frame type is template parameter and frame check is resolved at compile time
+template<modbus::FrameType frameType>
+class BasicModbusRtuSlave : public exchange::ActorHelper<BasicModbusRtuSlave<frameType>>, public IModbusSlave {
+  static_assert(frameType != modbus::FrameType::TCP, "serial line frame type is rtu or ascii");
+
+  using Base = exchange::ActorHelper<BasicModbusRtuSlave<frameType>>;
   using ModbusMessageInfoOpt = std::optional<ModbusMessageInfo>;
 
+  class ReadOp;
+
 public:
-  ModbusRtuSlave(const exchange::ExchangePtr &exchange,
-                 const ContextPtr &context,
-                 const std::string &device,
-                 const RtuOptions &options,
-                 const RouterPtr &router,
-                 modbus::FrameType frameType);
+  using typename Base::Ptr;
+  using typename Base::Weak;
 
-  ~ModbusRtuSlave() override;
+  BasicModbusRtuSlave(const exchange::ExchangePtr &exchange,
+                      const ContextPtr &context,
+                      const std::string &device,
+                      const RtuOptions &options,
+                      const RouterPtr &router);
+
+  ~BasicModbusRtuSlave() override;
 
   void Receive(const exchange::MessagePtr &message) override;
 
@@ -40,6 +51,9 @@ public:
 
   exchange::ActorId GetId() override;
 
+  // Call before start
+  void SetDelivery(Delivery delivery);
+
   void Start() override;
 
   void Stop() override;
@@ -47,22 +61,35 @@ public:
 private:
   void StartReadTask();
 
+  bool ReadComplete(const ModbusBufferPtr &modbusBuffer, asio::error_code ec, size_t size);
+
   ModbusMessagePtr MakeRequest(const ModbusBufferPtr &modbusBuffer, size_t size);
 
   modbus::TransactionId GetNextId();
 
   void StartWriteTask(const ModbusMessagePtr &modbusMessage);
 
+  void WriteNext();
+
   ModbusBufferPtr MakeResponse(const ModbusMessagePtr &modbusMessage);
 
 private:
   exchange::ActorId id_;
   exchange::ExchangeWeak exchange_;
-  asio::serial_port serialPort_;
+  StrandSerialPort serialPort_;
   RouterPtr router_;
-  modbus::FrameType frameType_;
   modbus::TransactionId idGenerator_;
-  Synchronized<ModbusMessageInfoOpt> syncRequestInfo_;
+  ModbusMessageInfoOpt requestInfo_;
+  Delivery delivery_;
+  HandlerMemoryPtr readMemory_;
+  HandlerMemoryPtr writeMemory_;
+  WriteQueue writeQueue_;
 };
 
+using ModbusRtuSlave = BasicModbusRtuSlave<modbus::FrameType::RTU>;
+using ModbusAsciiSlave = BasicModbusRtuSlave<modbus::FrameType::ASCII>;
+
+extern template class BasicModbusRtuSlave<modbus::FrameType::RTU>;
+extern template class BasicModbusRtuSlave<modbus::FrameType::ASCII>;
+
 }// namespace modbus_gateway
@@ -1,12 +1,21 @@
 #pragma once
 
-#include <common/limit_queue.h>
+#include <common/handler_memory.h>
+#include <common/mpsc_mailbox.h>
+#include <common/profile.h>
+#include <common/timer_wheel.h>
 #include <common/types_asio.h>
 #include <message/modbus_message.h>
+#include <transport/delivery.h>
+#include <transport/drop_policy.h>
+#include <transport/modbus_exception.h>
+#include <transport/request_queue.h>
+#include <transport/socket_options.h>
 
 #include <exchange/actor_helper.h>
 #include <exchange/iexchange.h>
 
+#include <memory>
 #include <optional>
 
 namespace modbus_gateway {
@@ -18,6 +27,8 @@ class ModbusTcpClient : public exchange::ActorHelper<ModbusTcpClient> {
     modbus::TransactionId id;
   };
 
+  class TransactionOp;
+
   enum class State {
     Idle,
     WaitConnect,
@@ -25,12 +36,16 @@ class ModbusTcpClient : public exchange::ActorHelper<ModbusTcpClient> {
     MessageProcess,
   };
 
+  static constexpr size_t mailboxCapacity = profile::mailboxCapacity;
+
 public:
   ModbusTcpClient(const exchange::ExchangePtr &exchange,
                   const ContextPtr &context,
+                  const TimerWheelPtr &timerWheel,
                   const asio::ip::address &addr,
                   asio::ip::port_type port,
-                  std::chrono::milliseconds timeout);
+                  std::chrono::milliseconds timeout,
+                  const SocketOptions &socketOptions);
 
   ~ModbusTcpClient() override;
 
@@ -42,8 +57,14 @@ public:
 
   exchange::ActorId GetId() override;
 
+  // Call before start
+  void SetDelivery(Delivery delivery);
+
+  // Call before start, queue of constructor keeps profile::queueDepth requests and drops oldest
+  void SetQueue(size_t size, DropPolicy dropPolicy);
+
 private:
-  void MessageProcess(const ModbusMessagePtr &message);
+  void MailboxProcess();
 
   void QueueProcessUnsafe();
 
@@ -53,9 +74,17 @@ private:
 
   void StartWaitTask();
 
-  ModbusMessagePtr MakeResponse(const ModbusBufferPtr &modbusBuffer, size_t size);
+  void WaitComplete(modbus::TransactionId id);
 
-  void StartReceiveTask();
+  // Answer request with exception, it is dropped from full mailbox or queue. Called by producer thread too
+  void RejectMessage(const ModbusMessagePtr &message, ModbusExceptionCode code);
+
+  // Slave did not answer current request, source gets exception instead of waiting for own timeout
+  void FailCurrentMessageUnsafe();
+
+  void ReceiveComplete(const ModbusBufferPtr &modbusBuffer, asio::error_code ec, size_t size);
+
+  ModbusMessagePtr MakeResponse(const ModbusBufferPtr &modbusBuffer, size_t size);
 
   static std::string StateToStr(State state);
 
@@ -64,15 +93,20 @@ private:
 private:
   exchange::ActorId id_;
   exchange::ExchangeWeak exchange_;
-  TcpSocketPtr socket_;
+  StrandTcpSocketPtr socket_;
   asio::ip::tcp::endpoint ep_;
   std::chrono::milliseconds timeout_;
-  asio::basic_waitable_timer<std::chrono::steady_clock> timer_;
-  std::mutex m_;
-  LimitQueue<ModbusMessagePtr> messageQueue_;
+  SocketOptions socketOptions_;
+  TimerWheelPtr timerWheel_;
+  TimerWheel::Handle deadline_;
+  MpscMailbox<ModbusMessagePtr> mailbox_;
+  RequestQueue messageQueue_;
   std::optional<ModbusCurrentMessage> currentMessage_;
   modbus::TransactionId transactionIdGenerator_;
   State state_;
+  Delivery delivery_;
+  HandlerMemoryPtr transactionMemory_;
+  HandlerMemoryPtr connectMemory_;
 };
 
 }// namespace modbus_gateway
@@ -1,24 +1,45 @@
 #pragma once
 
-#include <common/synchronized.h>
+#include <common/handler_memory.h>
+#include <common/memory_budget.h>
+#include <common/profile.h>
 #include <common/types_asio.h>
 #include <message/modbus_message.h>
 #include <message/modbus_message_info.h>
+#include <transport/delivery.h>
+#include <transport/inflight_table.h>
+#include <transport/mbap_reassembler.h>
+#include <transport/write_queue.h>
 #include <transport/irouter.h>
 
 #include <exchange/actor_helper.h>
 #include <exchange/iexchange.h>
 
+#include <atomic>
+#include <chrono>
 #include <optional>
 
 namespace modbus_gateway {
 
 class ModbusTcpConnection final : public exchange::ActorHelper<ModbusTcpConnection> {
-  using ModbusMessageInfoOpt = std::optional<ModbusMessageInfo>;
+  class ReceiveOp;
+
+  // Charged to memory budget for every request, charge is released with request message when master and
+  // connection drop it, response made from same buffer is not charged
+  static constexpr size_t requestCost = sizeof(modbus::ModbusBuffer) + sizeof(ModbusMessage);
+  // Socket is not read while budget is exhausted
+  static constexpr auto pauseTime = std::chrono::milliseconds(10);
+  // Receive ring keeps several pipelined requests
+  static constexpr size_t receiveBufferSize = 4 * MbapReassembler::maxAduSize;
+  // Responses gathered in one send, far below IOV_MAX
+  static constexpr size_t sendBatch = 64;
+  // Socket is not read while so many responses wait for write
+  static constexpr size_t writeCapacity = sendBatch;
 
 public:
+  // Remote endpoint is taken by server on accept, socket of reset connection has no remote endpoint
   ModbusTcpConnection(const exchange::ExchangePtr &exchange, exchange::ActorId serverId,
-                      TcpSocketPtr socket, const RouterPtr &router);
+                      StrandTcpSocketPtr socket, const TcpEndpoint &remoteEndpoint, const RouterPtr &router);
 
   ~ModbusTcpConnection() override;
 
@@ -30,27 +51,71 @@ public:
 
   exchange::ActorId GetId() override;
 
+  // Call before start
+  void SetDelivery(Delivery delivery);
+
+  // Call before start, connection without budget is not limited
+  void SetMemoryBudget(const MemoryBudgetPtr &memoryBudget);
+
+  // Call before start, requests over depth are rejected until responses are sent
+  void SetMaxInflight(size_t maxInflight);
+
+  // Call before start, slot of request without response is freed after timeout
+  void SetInflightTimeout(std::chrono::milliseconds timeout);
+
+  // Call before start, ack of every request is sent immediately instead of delayed
+  void SetQuickAck(bool quickAck);
+
   void Start();
 
   void Stop();
 
+  // Time of last received request or sent response, thread safe
+  std::chrono::steady_clock::time_point GetLastActivity() const;
+
+  asio::ip::address GetRemoteAddress() const;
+
 private:
+  void UpdateActivity();
+
   static ModbusMessagePtr
   MakeRequest(const ModbusBufferPtr &modbusBuffer, size_t size, exchange::ActorId masterId);
 
   void StartReceiveTask();
 
+  bool ReceiveComplete(asio::error_code ec, size_t size);
+
+  // Returns false if memory budget is exhausted, receive is paused
+  bool ProcessRequest(const exchange::ExchangePtr &exchange, const ModbusBufferPtr &modbusBuffer, size_t size);
+
+  void RejectRequest(const ModbusMessagePtr &modbusMessage);
+
   ModbusBufferPtr MakeResponse(const ModbusMessagePtr &modbusMessage);
 
   void StartSendTask(const ModbusMessagePtr &modbusMessage);
 
+  void SendBuffer(const ModbusBufferPtr &modbusBuffer);
+
+  void StartWriteTask();
+
 private:
   std::atomic<exchange::ActorId> id_;
   exchange::ExchangeWeak exchange_;
   exchange::ActorId serverId_;
-  TcpSocketPtr socket_;
+  StrandTcpSocketPtr socket_;
+  TcpEndpoint remoteEndpoint_;
+  std::atomic<std::chrono::steady_clock::rep> lastActivity_;
   RouterPtr router_;
-  Synchronized<ModbusMessageInfoOpt> syncRequestInfo_;
+  MbapReassembler mbapReassembler_;
+  InflightTable inflight_;
+  Delivery delivery_;
+  HandlerMemoryPtr receiveMemory_;
+  HandlerMemoryPtr sendMemory_;
+  WriteQueue writeQueue_;
+  MemoryBudgetPtr memoryBudget_;
+  StrandTimer pauseTimer_;
+  bool paused_;
+  bool quickAck_;
 };
 
 }// namespace modbus_gateway
@@ -1,26 +1,41 @@
 #pragma once
 
+#include <transport/connection_limits.h>
+#include <transport/delivery.h>
 #include <transport/modbus_tcp_connection.h>
 #include <transport/i_modbus_slave.h>
+#include <transport/socket_options.h>
 
+#include <common/memory_budget.h>
 #include <common/types_asio.h>
 
 #include <exchange/actor_helper.h>
 #include <exchange/iexchange.h>
 
+#include <atomic>
+#include <chrono>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 namespace modbus_gateway {
 
 class ModbusTcpServer final : public exchange::ActorHelper<ModbusTcpServer>, public IModbusSlave {
   using TcpClientPtr = std::shared_ptr<ModbusTcpConnection>;
   using ClientDb = std::unordered_map<exchange::ActorId, TcpClientPtr>;
+  using AddressCount = std::map<asio::ip::address, size_t>;
 
 public:
   ModbusTcpServer(const exchange::ExchangePtr &exchange, const ContextPtr &context, const asio::ip::address &addr,
-                  asio::ip::port_type port, const RouterPtr &router);
+                  asio::ip::port_type port, const RouterPtr &router, const SocketOptions &socketOptions);
+
+  // Sharded server: every context has own acceptor bound with SO_REUSEPORT,
+  // connection lives on context which accepted it
+  ModbusTcpServer(const exchange::ExchangePtr &exchange, const std::vector<ContextPtr> &contexts,
+                  const asio::ip::address &addr, asio::ip::port_type port, const RouterPtr &router,
+                  const SocketOptions &socketOptions);
 
   void Receive(const exchange::MessagePtr &message) override;
 
@@ -30,6 +45,23 @@ public:
 
   exchange::ActorId GetId() override;
 
+  // Call before start
+  void SetDelivery(Delivery delivery);
+
+  // Call before start. Every connection gets own budget with connection limit, it is part of global budget
+  void SetMemoryBudget(const MemoryBudgetPtr &memoryBudget, size_t connectionLimit);
+
+  // Call before start, transactions of one connection waiting for response
+  void SetMaxInflight(size_t maxInflight);
+
+  // Call before start, slot of request without response is freed after timeout
+  void SetInflightTimeout(std::chrono::milliseconds timeout);
+
+  // Call before start
+  void SetConnectionLimits(const ConnectionLimits &connectionLimits);
+
+  ConnectionStats GetConnectionStats() const;
+
   void Start() override;
 
   void Stop() override;
@@ -37,17 +69,48 @@ public:
   ~ModbusTcpServer() override;
 
 private:
-  void AcceptTask();
+  void AcceptTask(size_t shard);
 
   void ClientDisconnect(exchange::ActorId clientId);
 
+  // Return false if connection is over limits, least recently active connection may be evicted for it
+  bool AdmitUnsafe(const asio::ip::address &address, const exchange::ExchangePtr &exchange);
+
+  void CloseClientUnsafe(ClientDb::iterator it, const exchange::ExchangePtr &exchange);
+
+  void EraseClientUnsafe(ClientDb::iterator it);
+
+  void StartSweepTask();
+
+  void Sweep();
+
 private:
   std::atomic<exchange::ActorId> id_;
   exchange::ExchangeWeak exchange_;
-  TcpAcceptor acceptor_;
+  std::vector<ContextPtr> contexts_;
+  std::vector<TcpAcceptor> acceptors_;
   RouterPtr router_;
+  SocketOptions socketOptions_;
+  Delivery delivery_;
+  MemoryBudgetPtr memoryBudget_;
+  size_t connectionMemoryLimit_;
+  size_t maxInflight_;
+  std::chrono::milliseconds inflightTimeout_;
+  ConnectionLimits connectionLimits_;
+  // messages of server and sweep of idle connections are handled on one strand
+  asio::strand<ContextPtr::element_type::executor_type> strand_;
+  // one timer reaps idle connections of all shards
+  asio::steady_timer sweepTimer_;
+  std::atomic<bool> sweeping_;
+  std::atomic<uint64_t> accepted_;
+  std::atomic<uint64_t> rejected_;
+  std::atomic<uint64_t> reaped_;
+  std::atomic<uint64_t> evicted_;
+  // accept handlers of shards and stop run outside of strand
   std::mutex mutex_;
   ClientDb clientDb_;
+  // connections of every remote address, admission does not walk all clients
+  AddressCount addressCount_;
 };
 
 }// namespace modbus_gateway
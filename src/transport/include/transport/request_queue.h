@@ -0,0 +1,55 @@
+#pragma once
+
+#include <common/limit_queue.h>
+#include <common/timer_wheel.h>
+#include <message/modbus_message.h>
+#include <transport/drop_policy.h>
+
+#include <exchange/iexchange.h>
+
+#include <chrono>
+#include <memory>
+
+namespace modbus_gateway {
+
+// Requests waiting for master. Queued request is owned by deadline timer, it answers request with
+// "gateway target failed" exception when deadline is reached, queue keeps weak reference.
+// Full queue drops one request by policy. Not thread safe, used on master executor
+class RequestQueue {
+  struct QueuedMessage {
+    std::weak_ptr<ModbusMessagePtr::element_type> modbusMessage;
+    TimerWheel::Handle deadline;
+  };
+
+public:
+  RequestQueue(const exchange::ExchangeWeak &exchange, const TimerWheelPtr &timerWheel,
+               std::chrono::milliseconds timeout, size_t capacity, DropPolicy dropPolicy);
+
+  // Return dropped request, it is message itself if policy rejects it, nullptr if nothing is dropped.
+  // Deadline of dropped request is canceled, master answers it
+  ModbusMessagePtr Push(const ModbusMessagePtr &message);
+
+  // Return false if queue has no request before deadline
+  bool Pop(ModbusMessagePtr &message);
+
+  size_t Size() const;
+
+  bool Empty() const;
+
+  size_t Capacity() const;
+
+private:
+  // Return request if it is taken before deadline
+  ModbusMessagePtr Take(size_t pos);
+
+  void RemoveExpired();
+
+private:
+  exchange::ExchangeWeak exchange_;
+  TimerWheelPtr timerWheel_;
+  std::chrono::milliseconds timeout_;
+  LimitQueue<QueuedMessage> queue_;
+  DropPolicy dropPolicy_;
+};
+
+}// namespace modbus_gateway
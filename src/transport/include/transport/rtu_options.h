@@ -24,6 +24,6 @@ struct RtuOptions {
   std::optional<Rs485> rs485{};
 };
 
-void SetOptions( asio::serial_port& serialPort, const RtuOptions& options );
+void SetOptions( StrandSerialPort& serialPort, const RtuOptions& options );
 
 }// namespace modbus_gateway
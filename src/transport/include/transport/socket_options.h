@@ -0,0 +1,68 @@
+#pragma once
+
+#include <common/types_asio.h>
+
+#include <cstdint>
+#include <optional>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+namespace modbus_gateway {
+
+#ifdef SO_REUSEPORT
+using ReusePort = asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+#endif
+
+#ifdef SO_BUSY_POLL
+using BusyPoll = asio::detail::socket_option::integer<SOL_SOCKET, SO_BUSY_POLL>;
+#endif
+
+#ifdef TCP_QUICKACK
+using QuickAck = asio::detail::socket_option::boolean<IPPROTO_TCP, TCP_QUICKACK>;
+#endif
+
+#ifdef TCP_KEEPIDLE
+using KeepAliveIdle = asio::detail::socket_option::integer<IPPROTO_TCP, TCP_KEEPIDLE>;
+using KeepAliveInterval = asio::detail::socket_option::integer<IPPROTO_TCP, TCP_KEEPINTVL>;
+using KeepAliveCount = asio::detail::socket_option::integer<IPPROTO_TCP, TCP_KEEPCNT>;
+#endif
+
+#ifdef TCP_USER_TIMEOUT
+using UserTimeout = asio::detail::socket_option::integer<IPPROTO_TCP, TCP_USER_TIMEOUT>;
+#endif
+
+#ifdef SO_PRIORITY
+using Priority = asio::detail::socket_option::integer<SOL_SOCKET, SO_PRIORITY>;
+#endif
+
+using TypeOfService = asio::detail::socket_option::integer<IPPROTO_IP, IP_TOS>;
+using TrafficClass = asio::detail::socket_option::integer<IPPROTO_IPV6, IPV6_TCLASS>;
+
+// Not set option keeps system default
+struct SocketOptions {
+  std::optional<uint32_t> busyPoll{};// microseconds
+  std::optional<bool> noDelay{};
+  std::optional<bool> quickAck{};
+  std::optional<uint32_t> receiveBuffer{};// bytes
+  std::optional<uint32_t> sendBuffer{};   // bytes
+  std::optional<bool> keepAlive{};
+  std::optional<uint32_t> keepAliveIdle{};    // seconds
+  std::optional<uint32_t> keepAliveInterval{};// seconds
+  std::optional<uint32_t> keepAliveCount{};
+  std::optional<uint32_t> userTimeout{};// milliseconds
+  std::optional<uint32_t> priority{};
+  std::optional<uint8_t> dscp{};
+};
+
+// Errors are logged, connection works with system defaults
+void SetOptions(asio::ip::tcp::socket &socket, const SocketOptions &options);
+
+void SetOptions(StrandTcpSocket &socket, const SocketOptions &options);
+
+// Kernel leaves quick ack mode by itself, owner of socket sets it again after every receive
+void RearmQuickAck(asio::ip::tcp::socket &socket);
+
+void RearmQuickAck(StrandTcpSocket &socket);
+
+}// namespace modbus_gateway
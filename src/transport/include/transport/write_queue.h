@@ -0,0 +1,70 @@
+#pragma once
+
+#include <common/types_asio.h>
+#include <common/types_modbus.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace modbus_gateway {
+
+// Responses waiting for write. One write is outstanding, responses which are ready meanwhile
+// are gathered in next write, asio::async_write continues partial write. Not thread safe, used on executor of stream
+class WriteQueue {
+public:
+  // Buffer sequence refers to batch of queue, asio copies it without allocation
+  class Buffers {
+  public:
+    using value_type = asio::const_buffer;
+    using const_iterator = std::vector<asio::const_buffer>::const_iterator;
+
+    explicit Buffers(const std::vector<asio::const_buffer> &buffers)
+        : buffers_(&buffers) {}
+
+    const_iterator begin() const {
+      return buffers_->begin();
+    }
+
+    const_iterator end() const {
+      return buffers_->end();
+    }
+
+  private:
+    const std::vector<asio::const_buffer> *buffers_;
+  };
+
+  // Batch keeps at most maxBatch responses, serial line writes frame by frame.
+  // Capacity is limit of waiting responses, producer stops taking requests while queue is full
+  WriteQueue(size_t maxBatch, size_t capacity);
+
+  // Return true if queue was idle and write is started by caller. Response is queued also over capacity,
+  // request which is already taken must be answered
+  bool Push(const ModbusBufferPtr &modbusBuffer);
+
+  // Return true if waiting responses reach capacity
+  bool Full() const;
+
+  // Waiting responses, batch in write is not counted
+  size_t Size() const;
+
+  // Take next batch of responses, buffers are valid until batch is completed
+  Buffers StartBatch();
+
+  // Release written batch, return true if next batch is ready
+  bool CompleteBatch();
+
+  // Drop written and waiting responses after write error
+  void Reset();
+
+  size_t BatchSize() const;
+
+private:
+  size_t maxBatch_;
+  size_t capacity_;
+  std::vector<ModbusBufferPtr> pending_;
+  std::vector<ModbusBufferPtr> batch_;
+  std::vector<asio::const_buffer> gather_;
+  bool writing_;
+};
+
+}// namespace modbus_gateway
@@ -0,0 +1,70 @@
+#include <transport/inflight_table.h>
+
+#include <algorithm>
+#include <cassert>
+
+namespace modbus_gateway {
+
+InflightTable::InflightTable(size_t depth, std::chrono::milliseconds timeout)
+    : inflight_(), depth_(depth), timeout_(timeout) {
+  assert(depth_ > 0);
+  inflight_.reserve(depth_);
+}
+
+bool InflightTable::Insert(modbus::TransactionId id) {
+  const auto now = Clock::now();
+  const auto it = std::find_if(inflight_.begin(), inflight_.end(), [id](const Inflight &inflight) {
+    return inflight.id == id;
+  });
+  if (inflight_.end() != it) {
+    if (it->expire > now) {
+      return false;
+    }
+    // request with same id was not answered in time
+    it->expire = now + timeout_;
+    return true;
+  }
+
+  if (inflight_.size() >= depth_) {
+    RemoveExpired(now);
+    if (inflight_.size() >= depth_) {
+      return false;
+    }
+  }
+  inflight_.push_back({id, now + timeout_});
+  return true;
+}
+
+bool InflightTable::Erase(modbus::TransactionId id) {
+  const auto it = std::find_if(inflight_.begin(), inflight_.end(), [id](const Inflight &inflight) {
+    return inflight.id == id;
+  });
+  if (inflight_.end() == it) {
+    return false;
+  }
+  // order is not used, last slot fills the gap
+  *it = inflight_.back();
+  inflight_.pop_back();
+  return true;
+}
+
+size_t InflightTable::Size() const {
+  return inflight_.size();
+}
+
+size_t InflightTable::Depth() const {
+  return depth_;
+}
+
+std::chrono::milliseconds InflightTable::Timeout() const {
+  return timeout_;
+}
+
+void InflightTable::RemoveExpired(Clock::time_point now) {
+  inflight_.erase(std::remove_if(inflight_.begin(), inflight_.end(), [now](const Inflight &inflight) {
+                    return inflight.expire <= now;
+                  }),
+                  inflight_.end());
+}
+
+}// namespace modbus_gateway
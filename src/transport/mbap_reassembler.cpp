@@ -0,0 +1,77 @@
+#include <transport/mbap_reassembler.h>
+
+#include <algorithm>
+#include <cassert>
+
+namespace modbus_gateway {
+
+namespace {
+
+constexpr size_t protocolIdOffset = 2;
+constexpr size_t lengthOffset = 4;
+// length counts unit id and pdu, pdu has at least function code
+constexpr size_t minLength = 2;
+constexpr size_t maxLength = MbapReassembler::maxAduSize - (MbapReassembler::headerSize - 1);
+
+}// namespace
+
+MbapReassembler::MbapReassembler(size_t capacity)
+    : ring_(capacity), head_(0), size_(0) {
+  assert(capacity >= maxAduSize);
+}
+
+asio::mutable_buffer MbapReassembler::Prepare() {
+  if (0 == size_) {
+    // whole ring is free, receive from begin
+    head_ = 0;
+  }
+  const size_t tail = (head_ + size_) % ring_.size();
+  const size_t end = (tail < head_ || size_ == ring_.size()) ? head_ : ring_.size();
+  return asio::buffer(ring_.data() + tail, end - tail);
+}
+
+void MbapReassembler::Commit(size_t size) {
+  assert(size_ + size <= ring_.size());
+  size_ += size;
+}
+
+MbapReassembler::Result MbapReassembler::Next(size_t &aduSize) const {
+  if (size_ < headerSize) {
+    return Result::NeedMore;
+  }
+  const uint16_t protocolId = static_cast<uint16_t>(At(protocolIdOffset) << 8 | At(protocolIdOffset + 1));
+  const size_t length = static_cast<size_t>(At(lengthOffset) << 8 | At(lengthOffset + 1));
+  if (0 != protocolId || length < minLength || length > maxLength) {
+    return Result::Invalid;
+  }
+  aduSize = headerSize - 1 + length;
+  if (size_ < aduSize) {
+    return Result::NeedMore;
+  }
+  return Result::Complete;
+}
+
+void MbapReassembler::Take(uint8_t *adu, size_t aduSize) {
+  assert(aduSize <= size_);
+  // adu may go around end of ring
+  const size_t first = std::min(aduSize, ring_.size() - head_);
+  std::copy_n(ring_.data() + head_, first, adu);
+  std::copy_n(ring_.data(), aduSize - first, adu + first);
+  head_ = (head_ + aduSize) % ring_.size();
+  size_ -= aduSize;
+}
+
+void MbapReassembler::Reset() {
+  head_ = 0;
+  size_ = 0;
+}
+
+size_t MbapReassembler::Size() const {
+  return size_;
+}
+
+uint8_t MbapReassembler::At(size_t pos) const {
+  return ring_[(head_ + pos) % ring_.size()];
+}
+
+}// namespace modbus_gateway
@@ -0,0 +1,49 @@
+#include <transport/modbus_exception.h>
+
+#include <common/logger.h>
+#include <transport/frame_converter.h>
+
+namespace modbus_gateway {
+
+namespace {
+
+// MBAP header: transaction id, protocol id, length, unit id
+constexpr size_t lengthOffset = 4;
+constexpr size_t functionCodeOffset = 7;
+constexpr size_t exceptionCodeOffset = 8;
+// unit id, function code, exception code
+constexpr uint8_t exceptionLength = 3;
+constexpr size_t exceptionAduSize = exceptionCodeOffset + 1;
+constexpr uint8_t exceptionFlag = 0x80;
+
+}// namespace
+
+void MakeExceptionResponse(modbus::ModbusBuffer &modbusBuffer, ModbusExceptionCode code) {
+  ConvertFrame<modbus::FrameType::TCP>(modbusBuffer);
+  auto adu = modbusBuffer.begin();
+  adu[lengthOffset] = 0;
+  adu[lengthOffset + 1] = exceptionLength;
+  adu[functionCodeOffset] = static_cast<uint8_t>(adu[functionCodeOffset] | exceptionFlag);
+  adu[exceptionCodeOffset] = static_cast<uint8_t>(code);
+  modbusBuffer.SetAduSize(exceptionAduSize);
+}
+
+bool RejectRequest(const exchange::ExchangeWeak &exchange, const ModbusMessagePtr &message, ModbusExceptionCode code) {
+  const ModbusMessageInfo &messageInfo = message->GetModbusMessageInfo();
+  auto exchangePtr = exchange.lock();
+  if (!exchangePtr) {
+    MG_WARN("RejectRequest: exchange was deleted, message id {}, source id {}", messageInfo.GetTransactionId(),
+            messageInfo.GetSourceId());
+    return false;
+  }
+
+  const ModbusBufferPtr &modbusBuffer = message->GetModbusBuffer();
+  MakeExceptionResponse(*modbusBuffer, code);
+  const auto res = exchangePtr->Send(messageInfo.GetSourceId(), MakeModbusMessage(messageInfo, modbusBuffer));
+  if (!res) {
+    MG_TRACE("RejectRequest: send to actorId {} failed", messageInfo.GetSourceId());
+  }
+  return res;
+}
+
+}// namespace modbus_gateway
@@ -1,36 +1,87 @@
 #include <transport/modbus_rtu_master.h>
 
 #include <common/logger.h>
-
-#include <modbus/modbus_buffer_wrapper.h>
+#include <transport/frame_converter.h>
+#include <transport/modbus_exception.h>
 
 namespace modbus_gateway {
 
-ModbusRtuMaster::ModbusRtuMaster(const exchange::ExchangePtr &exchange,
-                                 const ContextPtr &context,
-                                 const std::string &device,
-                                 const RtuOptions &options,
-                                 std::chrono::milliseconds timeout,
-                                 modbus::FrameType frameType)
+// Write request and read response as one stackless coroutine on serial port strand,
+// timer runs beside and cancels read on timeout
+template<modbus::FrameType frameType>
+class BasicModbusRtuMaster<frameType>::TransactionOp : asio::coroutine {
+public:
+  TransactionOp(const Weak &weak, const HandlerMemoryPtr &memory, const ModbusBufferPtr &modbusBuffer)
+      : weak_(weak), memory_(memory), modbusBuffer_(modbusBuffer) {}
+
+  void operator()(asio::error_code ec = {}, size_t size = 0) {
+    Ptr self = weak_.lock();
+    if (!self) {
+      MG_WARN("ModbusRtuMaster::transaction: actor was deleted")
+      return;
+    }
+
+    ASIO_CORO_REENTER(*this) {
+      ASIO_CORO_YIELD self->serialPort_.async_write_some(
+          asio::buffer(modbusBuffer_->begin().base(), modbusBuffer_->GetAduSize()), std::move(*this));
+      if (ec) {
+        MG_ERROR("ModbusRtuMaster({})::write: error {}", self->id_, ec.message());
+        self->FailCurrentMessageUnsafe();
+        self->QueueProcessUnsafe();
+        return;
+      }
+      MG_TRACE("ModbusRtuMaster({})::write: write {} bytes", self->id_, size);
+
+      self->StartWaitTask();
+      modbusBuffer_ = MakeModbusBuffer(frameType);
+      ASIO_CORO_YIELD self->serialPort_.async_read_some(
+          asio::buffer(modbusBuffer_->begin().operator->(), modbusBuffer_->GetAduSize()), std::move(*this));
+      self->ReadComplete(modbusBuffer_, ec, size);
+    }
+  }
+
+  using allocator_type = HandlerAllocator<void>;
+
+  allocator_type get_allocator() const noexcept {
+    return allocator_type(memory_);
+  }
+
+private:
+  Weak weak_;
+  HandlerMemoryPtr memory_;
+  ModbusBufferPtr modbusBuffer_;
+};
+
+template<modbus::FrameType frameType>
+BasicModbusRtuMaster<frameType>::BasicModbusRtuMaster(const exchange::ExchangePtr &exchange,
+                                                      const ContextPtr &context,
+                                                      const TimerWheelPtr &timerWheel,
+                                                      const std::string &device,
+                                                      const RtuOptions &options,
+                                                      std::chrono::milliseconds timeout)
     : id_(exchange::defaultId),
       exchange_(exchange),
-      serialPort_(*context),
+      serialPort_(asio::make_strand(*context)),
       timeout_(timeout),
-      frameType_(frameType),
-      timer_(serialPort_.get_executor()),
-      m_(), messageQueue_(),
+      timerWheel_(timerWheel),
+      deadline_(),
+      mailbox_(mailboxCapacity),
+      messageQueue_(exchange, timerWheel, timeout, profile::queueDepth, DropPolicy::DropOldest),
       currentMessage_(std::nullopt),
-      transactionIdGenerator_(0) {
+      transactionIdGenerator_(0),
+      delivery_(Delivery::Post),
+      transactionMemory_(std::make_shared<HandlerMemory>()) {
   serialPort_.open(device);
   SetOptions(serialPort_,options);
 
   assert(exchange);
-  assert(frameType_ != modbus::TCP);
+  assert(timerWheel_);
 
   MG_DEBUG("ModbusRtuMaster::Ctor: {}", device);
 }
 
-ModbusRtuMaster::~ModbusRtuMaster() {
+template<modbus::FrameType frameType>
+BasicModbusRtuMaster<frameType>::~BasicModbusRtuMaster() {
   MG_DEBUG("ModbusRtuMaster({})::Dtor", id_);
   asio::error_code ec;
   ec = serialPort_.cancel(ec);
@@ -43,36 +94,90 @@ ModbusRtuMaster::~ModbusRtuMaster() {
   }
 }
 
-void ModbusRtuMaster::Receive(const exchange::MessagePtr &message) {
-  auto modbusMessage = std::dynamic_pointer_cast<ModbusMessagePtr::element_type>(message);
+template<modbus::FrameType frameType>
+void BasicModbusRtuMaster<frameType>::Receive(const exchange::MessagePtr &message) {
+  auto modbusMessage = MessageCast<ModbusMessage>(message);
   if (modbusMessage) {
     MG_TRACE("ModbusRtuMaster({})::Receive: ModbusMessage", id_);
-    MessageProcess(modbusMessage);
+    bool wake = false;
+    if (!mailbox_.Push(modbusMessage, wake)) {
+      MG_ERROR("ModbusRtuMaster({})::Receive: mailbox is full", id_);
+      RejectMessage(modbusMessage, ModbusExceptionCode::ServerDeviceBusy);
+      return;
+    }
+    if (wake) {
+      // mailbox was empty, consumer is not scheduled
+      Weak weak = this->GetWeak();
+      Deliver(delivery_, serialPort_.get_executor(), [weak]() {
+        Ptr self = weak.lock();
+        if (!self) {
+          MG_WARN("ModbusRtuMaster::receive: actor was deleted")
+          return;
+        }
+        self->MailboxProcess();
+      });
+    }
     return;
   }
   MG_WARN("ModbusRtuMaster({})::Receive: unsupported message", id_);
 }
 
-void ModbusRtuMaster::SetId(exchange::ActorId id) {
+template<modbus::FrameType frameType>
+void BasicModbusRtuMaster<frameType>::SetId(exchange::ActorId id) {
   id_ = id;
 }
 
-void ModbusRtuMaster::ResetId() {
+template<modbus::FrameType frameType>
+void BasicModbusRtuMaster<frameType>::ResetId() {
   id_ = exchange::defaultId;
 }
 
-exchange::ActorId ModbusRtuMaster::GetId() {
+template<modbus::FrameType frameType>
+exchange::ActorId BasicModbusRtuMaster<frameType>::GetId() {
   return id_;
 }
 
-void ModbusRtuMaster::MessageProcess(const ModbusMessagePtr &message) {
-  std::lock_guard<std::mutex> lock(m_);
-  messageQueue_.Push(message);
-  MG_TRACE("ModbusRtuMaster({})::MessageProcess: message in queue {}", id_, messageQueue_.Size());
+template<modbus::FrameType frameType>
+void BasicModbusRtuMaster<frameType>::SetDelivery(Delivery delivery) {
+  delivery_ = delivery;
+}
+
+template<modbus::FrameType frameType>
+void BasicModbusRtuMaster<frameType>::SetQueue(size_t size, DropPolicy dropPolicy) {
+  messageQueue_ = RequestQueue(exchange_, timerWheel_, timeout_, profile::Clamp(size, profile::queueDepth), dropPolicy);
+}
+
+template<modbus::FrameType frameType>
+void BasicModbusRtuMaster<frameType>::MailboxProcess() {
+  ModbusMessagePtr message;
+  bool more = true;
+  while (more && mailbox_.Pop(message)) {
+    const auto dropped = messageQueue_.Push(message);
+    if (dropped) {
+      RejectMessage(dropped, ModbusExceptionCode::ServerDeviceBusy);
+    }
+    message.reset();
+    more = mailbox_.Release();
+  }
+  MG_TRACE("ModbusRtuMaster({})::MailboxProcess: message in queue {}", id_, messageQueue_.Size());
   QueueProcessUnsafe();
+
+  if (more) {
+    // next message is not published by producer yet
+    Weak weak = this->GetWeak();
+    asio::post(serialPort_.get_executor(), [weak]() {
+      Ptr self = weak.lock();
+      if (!self) {
+        MG_WARN("ModbusRtuMaster::mailbox: actor was deleted")
+        return;
+      }
+      self->MailboxProcess();
+    });
+  }
 }
 
-void ModbusRtuMaster::QueueProcessUnsafe() {
+template<modbus::FrameType frameType>
+void BasicModbusRtuMaster<frameType>::QueueProcessUnsafe() {
   if (messageQueue_.Empty()) {
     MG_TRACE("ModbusRtuMaster({})::QueueProcess: queue is empty", id_);
     return;
@@ -83,39 +188,24 @@ void ModbusRtuMaster::QueueProcessUnsafe() {
     return;
   }
 
-  while (!messageQueue_.Empty()) {
-    const auto &message = messageQueue_.Front();
-    if (!message->GetModbusMessageInfo().TimeoutReached(timeout_)) {
-      break;
-    }
-
-    const auto &messageInfo = message->GetModbusMessageInfo();
-    MG_INFO(
-        "ModbusRtuMaster({})::QueueProcess: message reached timeout {}, message id {}, source id {}", id_,
-        timeout_.count(), messageInfo.GetTransactionId(), messageInfo.GetSourceId());
-    messageQueue_.Pop();
-  }
+  StartMessageTaskUnsafe();
+}
 
-  if (messageQueue_.Empty()) {
-    MG_INFO("ModbusRtuMaster({})::QueueProcess: message queue empty", id_);
+template<modbus::FrameType frameType>
+void BasicModbusRtuMaster<frameType>::StartMessageTaskUnsafe() {
+  ModbusMessagePtr message;
+  if (!messageQueue_.Pop(message)) {
+    MG_INFO("ModbusRtuMaster({})::StartMessageTask: message queue empty", id_);
     return;
   }
 
-  StartMessageTaskUnsafe();
-}
-
-void ModbusRtuMaster::StartMessageTaskUnsafe() {
   const auto transactionId = ++transactionIdGenerator_;
-  currentMessage_ = {messageQueue_.Front(), transactionId};
-  messageQueue_.Pop();
+  currentMessage_ = {message, transactionId};
 
   ModbusBufferPtr modbusBuffer = currentMessage_->modbusMessage->GetModbusBuffer();
   const auto originType = modbusBuffer->GetType();
-  modbusBuffer->ConvertTo(frameType_);
+  ConvertFrame<frameType>(*modbusBuffer);
   {
-    auto wrapper = modbus::MakeModbusBufferWrapper(*modbusBuffer);
-    wrapper->Update();
-
     MG_DEBUG("ModbusRtuMaster({})::StartMessageTask: frame type {}->{}, actor id {}, transaction Id {}->{}",
              id_,
              static_cast<int>(originType),
@@ -126,110 +216,98 @@ void ModbusRtuMaster::StartMessageTaskUnsafe() {
     MG_DEBUG("ModbusRtuMaster({})::StartMessageTask: request: [{:X}]", id_, fmt::join(*modbusBuffer, " "));
   }
 
-  Weak weak = GetWeak();
-  serialPort_.async_write_some(asio::buffer(modbusBuffer->begin().base(), modbusBuffer->GetAduSize()),
-                               [weak](asio::error_code ec, size_t size) {
-                                 Ptr self = weak.lock();
-                                 if (!self) {
-                                   MG_WARN("ModbusRtuMaster::write: actor was deleted")
-                                   return;
-                                 }
-
-                                 std::lock_guard<std::mutex> lock(self->m_);
-
-                                 if (ec) {
-                                   MG_ERROR("ModbusRtuMaster({})::write: error {}", self->id_, ec.message());
-                                   self->currentMessage_.reset();
-                                   return;
-                                 }
-
-                                 MG_TRACE("ModbusRtuMaster({})::write: write {} bytes", self->id_, size);
-                                 self->StartWaitTask();
-                                 self->StartReadTask();
-                               });
+  TransactionOp(this->GetWeak(), transactionMemory_, modbusBuffer)();
 }
 
-void ModbusRtuMaster::StartWaitTask() {
+template<modbus::FrameType frameType>
+void BasicModbusRtuMaster<frameType>::StartWaitTask() {
   MG_TRACE("ModbusRtuMaster({})::StartWaitTask timeout {}ms", id_, timeout_.count())
-  timer_.expires_after(timeout_);
+  const auto id = currentMessage_->id;
 
-  Weak weak = GetWeak();
-  timer_.async_wait([weak](asio::error_code ec) {
+  Weak weak = this->GetWeak();
+  deadline_ = timerWheel_->Arm(timeout_, [weak, id]() {
     Ptr self = weak.lock();
     if (!self) {
       MG_WARN("ModbusRtuMaster::wait: actor was deleted")
       return;
     }
-
-    std::lock_guard<std::mutex> lock(self->m_);
-
-    if (ec) {
-      if (asio::error::operation_aborted == ec) {
-        MG_TRACE("ModbusRtuMaster({})::wait: canceled", self->id_);
+    // timer wheel callback runs on wheel strand
+    asio::post(self->serialPort_.get_executor(), [weak, id]() {
+      Ptr self = weak.lock();
+      if (!self) {
+        MG_WARN("ModbusRtuMaster::wait: actor was deleted")
         return;
       }
-      MG_ERROR("ModbusRtuMaster({})::wait: error: {}", self->id_, ec.message())
-      return;
-    }
+      self->WaitComplete(id);
+    });
+  });
+}
+
+template<modbus::FrameType frameType>
+void BasicModbusRtuMaster<frameType>::WaitComplete(modbus::TransactionId id) {
+  if (!currentMessage_ || currentMessage_->id != id) {
+    MG_TRACE("ModbusRtuMaster({})::wait: transaction {} already completed", id_, id);
+    return;
+  }
 
-    MG_ERROR("ModbusRtuMaster({})::wait: achieve timeout, cancel read task", self->id_);
-    ec = self->serialPort_.cancel(ec);
-    if (ec) {
-      MG_WARN("ModbusRtuMaster({})::wait: socket cancel error: {}", self->id_, ec.message());
+  MG_ERROR("ModbusRtuMaster({})::wait: achieve timeout, cancel read task", id_);
+  asio::error_code ec;
+  ec = serialPort_.cancel(ec);
+  if (ec) {
+    MG_WARN("ModbusRtuMaster({})::wait: socket cancel error: {}", id_, ec.message());
+  }
+}
+template<modbus::FrameType frameType>
+void BasicModbusRtuMaster<frameType>::ReadComplete(const ModbusBufferPtr &modbusBuffer, asio::error_code ec, size_t size) {
+  auto exchange = exchange_.lock();
+  if (!exchange) {
+    MG_WARN("ModbusRtuMaster({})::read: exchange was deleted", id_);
+    return;
+  }
+
+  if (!timerWheel_->Cancel(deadline_)) {
+    MG_DEBUG("ModbusRtuMaster({})::read: deadline already reached", id_);
+  }
+
+  if (ec) {
+    MG_ERROR("ModbusRtuMaster({})::read: error: {}", id_, ec.message());
+    FailCurrentMessageUnsafe();
+    QueueProcessUnsafe();
+    return;
+  }
+
+  MG_TRACE("ModbusRtuMaster({})::read: receive {} bytes", id_, size);
+  const auto modbusMessage = MakeResponse(modbusBuffer, size);
+  if (modbusMessage) {
+    const auto actorId = modbusMessage->GetModbusMessageInfo().GetSourceId();
+    const auto res = exchange->Send(actorId, modbusMessage);
+    if (!res) {
+      MG_TRACE("ModbusRtuMaster({})::read: send to actorId {} failed", id_, actorId);
     }
-  });
+  }
+
+  QueueProcessUnsafe();
 }
-void ModbusRtuMaster::StartReadTask() {
-  MG_TRACE("ModbusRtuMaster({})::StartReadTask", id_);
-
-  auto modbusBuffer = std::make_shared<modbus::ModbusBuffer>(frameType_);
-  Weak weak = GetWeak();
-  serialPort_.async_read_some(asio::buffer(modbusBuffer->begin().operator->(), modbusBuffer->GetAduSize()),
-                              [weak, modbusBuffer](asio::error_code ec, size_t size) {
-                                Ptr self = weak.lock();
-                                if (!self) {
-                                  MG_WARN("ModbusRtuMaster::read: actor was deleted")
-                                  return;
-                                }
-
-                                auto exchange = self->exchange_.lock();
-                                if (!exchange) {
-                                  MG_WARN("ModbusRtuSlave({})::accept: exchange was deleted");
-                                  return;
-                                }
-
-                                std::lock_guard<std::mutex> lock(self->m_);
-
-                                try {
-                                  const auto tp = self->timer_.expiry() - std::chrono::steady_clock::now();
-                                  const auto exp = tp.count() / std::chrono::microseconds::period::den;
-                                  MG_DEBUG("ModbusRtuMaster({})::read: left {}ms", self->id_, exp);
-                                  self->timer_.cancel();
-                                } catch (const asio::system_error &e) {
-                                  MG_ERROR("ModbusRtuMaster({})::read: timer cancel error: {}", self->id_, ec.message());
-                                }
-
-                                if (ec) {
-                                  MG_ERROR("ModbusRtuMaster({})::read: error: {}", self->id_, ec.message());
-                                  self->currentMessage_.reset();
-                                  return;
-                                }
-
-                                MG_TRACE("ModbusRtuMaster({})::read: receive {} bytes", self->id_, size);
-                                const auto modbusMessage = self->MakeResponse(modbusBuffer, size);
-                                if (modbusMessage) {
-                                  const auto actorId = modbusMessage->GetModbusMessageInfo().GetSourceId();
-                                  const auto res = exchange->Send(actorId, modbusMessage);
-                                  if (!res) {
-                                    MG_TRACE("ModbusRtuMaster({})::read: send to actorId {} failed", self->id_, actorId);
-                                  }
-                                }
-
-                                self->QueueProcessUnsafe();
-                              });
+
+template<modbus::FrameType frameType>
+void BasicModbusRtuMaster<frameType>::RejectMessage(const ModbusMessagePtr &message, ModbusExceptionCode code) {
+  const ModbusMessageInfo &messageInfo = message->GetModbusMessageInfo();
+  MG_WARN("ModbusRtuMaster({})::RejectMessage: drop message id {}, source id {}", id_, messageInfo.GetTransactionId(),
+          messageInfo.GetSourceId());
+  RejectRequest(exchange_, message, code);
 }
 
-ModbusMessagePtr ModbusRtuMaster::MakeResponse(const ModbusBufferPtr &modbusBuffer, size_t size) {
+template<modbus::FrameType frameType>
+void BasicModbusRtuMaster<frameType>::FailCurrentMessageUnsafe() {
+  if (!currentMessage_) {
+    return;
+  }
+  RejectMessage(currentMessage_->modbusMessage, ModbusExceptionCode::GatewayTargetFailed);
+  currentMessage_.reset();
+}
+
+template<modbus::FrameType frameType>
+ModbusMessagePtr BasicModbusRtuMaster<frameType>::MakeResponse(const ModbusBufferPtr &modbusBuffer, size_t size) {
   if (!currentMessage_) {
     return nullptr;
   }
@@ -248,8 +326,7 @@ ModbusMessagePtr ModbusRtuMaster::MakeResponse(const ModbusBufferPtr &modbusBuff
   const ModbusMessageInfo currentInfo = currentMessage->GetModbusMessageInfo();
 
   {
-    const auto wrapper = modbus::MakeModbusBufferWrapper(*modbusBuffer);
-    const auto result = wrapper->Check();
+    const auto result = CheckFrame<frameType>(*modbusBuffer);
     if (result != modbus::CheckFrameResult::NoError) {
       MG_ERROR("ModbusRtuMaster({})::MakeResponse: check message failed: {}", id_, result)
       return nullptr;
@@ -262,8 +339,10 @@ ModbusMessagePtr ModbusRtuMaster::MakeResponse(const ModbusBufferPtr &modbusBuff
            id,
            currentInfo.GetTransactionId());
 
-  return ModbusMessage::Create(currentInfo, modbusBuffer);
+  return MakeModbusMessage(currentInfo, modbusBuffer);
 }
 
+template class BasicModbusRtuMaster<modbus::FrameType::RTU>;
+template class BasicModbusRtuMaster<modbus::FrameType::ASCII>;
+
 }// namespace modbus_gateway
-// namespace modbus_gateway
@@ -1,26 +1,64 @@
 #include <transport/modbus_rtu_slave.h>
 
 #include <common/logger.h>
+#include <transport/frame_converter.h>
 
 #include <modbus/modbus_buffer.h>
-#include <modbus/modbus_buffer_wrapper.h>
 
 namespace modbus_gateway {
 
-ModbusRtuSlave::ModbusRtuSlave(const exchange::ExchangePtr &exchange,
-                               const ContextPtr &context,
-                               const std::string &device,
-                               const RtuOptions &options,
-                               const RouterPtr &router,
-                               modbus::FrameType frameType)
+// Read loop as stackless coroutine on serial port strand
+template<modbus::FrameType frameType>
+class BasicModbusRtuSlave<frameType>::ReadOp : asio::coroutine {
+public:
+  ReadOp(const Weak &weak, const HandlerMemoryPtr &memory)
+      : weak_(weak), memory_(memory), modbusBuffer_() {}
+
+  void operator()(asio::error_code ec = {}, size_t size = 0) {
+    Ptr self = weak_.lock();
+    if (!self) {
+      MG_WARN("ModbusRtuSlave::read: actor was deleted");
+      return;
+    }
+
+    ASIO_CORO_REENTER(*this) {
+      do {
+        modbusBuffer_ = MakeModbusBuffer(frameType);
+        ASIO_CORO_YIELD self->serialPort_.async_read_some(
+            asio::buffer(modbusBuffer_->begin().operator->(), modbusBuffer_->GetAduSize()), std::move(*this));
+      } while (self->ReadComplete(modbusBuffer_, ec, size));
+    }
+  }
+
+  using allocator_type = HandlerAllocator<void>;
+
+  allocator_type get_allocator() const noexcept {
+    return allocator_type(memory_);
+  }
+
+private:
+  Weak weak_;
+  HandlerMemoryPtr memory_;
+  ModbusBufferPtr modbusBuffer_;
+};
+
+template<modbus::FrameType frameType>
+BasicModbusRtuSlave<frameType>::BasicModbusRtuSlave(const exchange::ExchangePtr &exchange,
+                                                    const ContextPtr &context,
+                                                    const std::string &device,
+                                                    const RtuOptions &options,
+                                                    const RouterPtr &router)
     : IModbusSlave(TransportType::RtuSlave),
       id_(exchange::defaultId),
       exchange_(exchange),
-      serialPort_(*context),
+      serialPort_(asio::make_strand(*context)),
       router_(router),
-      frameType_(frameType),
       idGenerator_(0),
-      syncRequestInfo_(std::nullopt) {
+      requestInfo_(std::nullopt),
+      delivery_(Delivery::Post),
+      readMemory_(std::make_shared<HandlerMemory>()),
+      writeMemory_(std::make_shared<HandlerMemory>()),
+      writeQueue_(1, 1) {
   serialPort_.open(device);
   serialPort_.set_option(options.baudRate);
   serialPort_.set_option(options.characterSize);
@@ -30,12 +68,12 @@ ModbusRtuSlave::ModbusRtuSlave(const exchange::ExchangePtr &exchange,
 
   assert(exchange);
   assert(router);
-  assert(frameType_ != modbus::TCP);
 
   MG_DEBUG("ModbusRtuSlave({})::Ctor: {}", id_, device);
 }
 
-ModbusRtuSlave::~ModbusRtuSlave() {
+template<modbus::FrameType frameType>
+BasicModbusRtuSlave<frameType>::~BasicModbusRtuSlave() {
   MG_DEBUG("ModbusRtuSlave({})::Dtor", id_);
   Stop();
   asio::error_code ec;
@@ -45,34 +83,53 @@ ModbusRtuSlave::~ModbusRtuSlave() {
   }
 }
 
-void ModbusRtuSlave::Receive(const exchange::MessagePtr &message) {
-  const ModbusMessagePtr &modbusMessage = std::dynamic_pointer_cast<ModbusMessagePtr::element_type>(message);
+template<modbus::FrameType frameType>
+void BasicModbusRtuSlave<frameType>::Receive(const exchange::MessagePtr &message) {
+  const ModbusMessagePtr modbusMessage = MessageCast<ModbusMessage>(message);
   if (modbusMessage) {
     MG_TRACE("ModbusRtuSlave({})::Receive: ModbusMessage", id_);
-    StartWriteTask(modbusMessage);
+    Weak weak = this->GetWeak();
+    Deliver(delivery_, serialPort_.get_executor(), [weak, modbusMessage]() {
+      Ptr self = weak.lock();
+      if (!self) {
+        MG_WARN("ModbusRtuSlave::receive: actor was deleted");
+        return;
+      }
+      self->StartWriteTask(modbusMessage);
+    });
     return;
   }
   MG_WARN("ModbusRtuSlave({})::Receive: unsupported message", id_);
 }
 
-void ModbusRtuSlave::SetId(exchange::ActorId id) {
+template<modbus::FrameType frameType>
+void BasicModbusRtuSlave<frameType>::SetId(exchange::ActorId id) {
   id_ = id;
 }
 
-void ModbusRtuSlave::ResetId() {
+template<modbus::FrameType frameType>
+void BasicModbusRtuSlave<frameType>::ResetId() {
   id_ = exchange::defaultId;
 }
 
-exchange::ActorId ModbusRtuSlave::GetId() {
+template<modbus::FrameType frameType>
+exchange::ActorId BasicModbusRtuSlave<frameType>::GetId() {
   return id_;
 }
 
-void ModbusRtuSlave::Start() {
+template<modbus::FrameType frameType>
+void BasicModbusRtuSlave<frameType>::SetDelivery(Delivery delivery) {
+  delivery_ = delivery;
+}
+
+template<modbus::FrameType frameType>
+void BasicModbusRtuSlave<frameType>::Start() {
   MG_DEBUG("ModbusRtuSlave({})::Start", id_);
   StartReadTask();
 }
 
-void ModbusRtuSlave::Stop() {
+template<modbus::FrameType frameType>
+void BasicModbusRtuSlave<frameType>::Stop() {
   MG_DEBUG("ModbusRtuSlave({})::Stop", id_);
   asio::error_code ec;
   ec = serialPort_.cancel(ec);
@@ -81,71 +138,59 @@ void ModbusRtuSlave::Stop() {
   }
 }
 
-void ModbusRtuSlave::StartReadTask() {
+template<modbus::FrameType frameType>
+void BasicModbusRtuSlave<frameType>::StartReadTask() {
   MG_TRACE("ModbusRtuSlave({})::StartReadTask", id_);
-  Weak weak = GetWeak();
-  auto modbusBuffer = std::make_shared<modbus::ModbusBuffer>(frameType_);
-  serialPort_.async_read_some(asio::buffer(modbusBuffer->begin().operator->(), modbusBuffer->GetAduSize()),
-                              [weak, modbusBuffer](asio::error_code ec, size_t size) {
-                                Ptr self = weak.lock();
-                                if (!self) {
-                                  MG_WARN("ModbusRtuSlave::read: actor was deleted");
-                                  return;
-                                }
-
-                                auto exchange = self->exchange_.lock();
-                                if (!exchange) {
-                                  MG_WARN("ModbusRtuSlave({})::accept: exchange was deleted");
-                                  return;
-                                }
-
-                                if (ec) {
-                                  if ((asio::error::eof == ec)
-                                      || (asio::error::connection_reset == ec)
-                                      || (asio::error::operation_aborted == ec)) {
-                                    MG_INFO("ModbusRtuSlave({})::read: cancelled", self->id_);
-                                    return;
-                                  }
-                                  MG_ERROR("ModbusRtuSlave({})::read: error: {}", self->id_, ec.message());
-                                  self->StartReadTask();
-                                  return;
-                                }
-
-                                MG_TRACE("ModbusRtuSlave({})::read: {} bytes", self->id_, size);
-                                auto message = self->MakeRequest(modbusBuffer, size);
-                                if (!message) {
-                                  MG_ERROR("ModbusRtuSlave: receive: invalid request, start receive task");
-                                  self->StartReadTask();
-                                  return;
-                                }
-
-                                {
-                                  auto access = self->syncRequestInfo_.GetAccess();
-                                  access.ref = message->GetModbusMessageInfo();
-                                }
-
-                                const modbus::UnitId unitId = message->GetModbusBuffer()->GetUnitId();
-                                const exchange::ActorId actorId = self->router_->Route(unitId);
-                                MG_DEBUG("ModbusRtuSlave({})::read: unit id {} route to actor id {}",
-                                         self->id_, unitId, actorId);
-                                const auto res = exchange->Send(actorId, message);
-                                if (!res) {
-                                  MG_ERROR("ModbusRtuSlave({})::read: route to actor id {} failed",
-                                           self->id_, actorId);
-                                }
-                                self->StartReadTask();
-                              });
-}
-
-ModbusMessagePtr ModbusRtuSlave::MakeRequest(const ModbusBufferPtr &modbusBuffer, size_t size) {
+  ReadOp{this->GetWeak(), readMemory_}();
+}
+
+template<modbus::FrameType frameType>
+bool BasicModbusRtuSlave<frameType>::ReadComplete(const ModbusBufferPtr &modbusBuffer, asio::error_code ec, size_t size) {
+  auto exchange = exchange_.lock();
+  if (!exchange) {
+    MG_WARN("ModbusRtuSlave({})::read: exchange was deleted", id_);
+    return false;
+  }
+
+  if (ec) {
+    if ((asio::error::eof == ec)
+        || (asio::error::connection_reset == ec)
+        || (asio::error::operation_aborted == ec)) {
+      MG_INFO("ModbusRtuSlave({})::read: cancelled", id_);
+      return false;
+    }
+    MG_ERROR("ModbusRtuSlave({})::read: error: {}", id_, ec.message());
+    return true;
+  }
+
+  MG_TRACE("ModbusRtuSlave({})::read: {} bytes", id_, size);
+  auto message = MakeRequest(modbusBuffer, size);
+  if (!message) {
+    MG_ERROR("ModbusRtuSlave({})::read: invalid request, start read task", id_);
+    return true;
+  }
+
+  requestInfo_ = message->GetModbusMessageInfo();
+
+  const modbus::UnitId unitId = message->GetModbusBuffer()->GetUnitId();
+  const exchange::ActorId actorId = router_->Route(unitId);
+  MG_DEBUG("ModbusRtuSlave({})::read: unit id {} route to actor id {}", id_, unitId, actorId);
+  const auto res = exchange->Send(actorId, message);
+  if (!res) {
+    MG_ERROR("ModbusRtuSlave({})::read: route to actor id {} failed", id_, actorId);
+  }
+  return true;
+}
+
+template<modbus::FrameType frameType>
+ModbusMessagePtr BasicModbusRtuSlave<frameType>::MakeRequest(const ModbusBufferPtr &modbusBuffer, size_t size) {
   if (!modbusBuffer->SetAduSize(size)) {
     MG_ERROR("ModbusRtuSlave({})::MakeRequest: invalid adu size", id_);
     return nullptr;
   }
   MG_TRACE("ModbusRtuSlave({})::MakeRequest: request: [{:X}]", id_, fmt::join(*modbusBuffer, " "))
 
-  const auto wrapper = modbus::MakeModbusBufferWrapper(*modbusBuffer);
-  const auto checkFrameResult = wrapper->Check();
+  const auto checkFrameResult = CheckFrame<frameType>(*modbusBuffer);
   if (checkFrameResult != modbus::CheckFrameResult::NoError) {
     MG_ERROR("ModbusRtuSlave({})::MakeRequest: invalid frame {}", id_, checkFrameResult);
     return nullptr;
@@ -157,39 +202,54 @@ ModbusMessagePtr ModbusRtuSlave::MakeRequest(const ModbusBufferPtr &modbusBuffer
   MG_DEBUG("ModbusRtuSlave({})::MakeRequest: transaction id {}", id_, transactionId);
 
   ModbusMessageInfo modbusMessageInfo(id_, transactionId);
-  return std::make_shared<ModbusMessagePtr::element_type>(modbusMessageInfo, modbusBuffer);
+  return MakeModbusMessage(modbusMessageInfo, modbusBuffer);
 }
 
-modbus::TransactionId ModbusRtuSlave::GetNextId() {
+template<modbus::FrameType frameType>
+modbus::TransactionId BasicModbusRtuSlave<frameType>::GetNextId() {
   return ++idGenerator_;
 }
 
-void ModbusRtuSlave::StartWriteTask(const ModbusMessagePtr &modbusMessage) {
+template<modbus::FrameType frameType>
+void BasicModbusRtuSlave<frameType>::StartWriteTask(const ModbusMessagePtr &modbusMessage) {
   MG_TRACE("ModbusRtuSlave({})::StartWriteTask", id_);
   ModbusBufferPtr modbusBuffer = MakeResponse(modbusMessage);
   if (!modbusBuffer) {
     return;
   }
 
-  Weak weak = GetWeak();
-  serialPort_.async_write_some(asio::buffer(modbusBuffer->begin().operator->(), modbusBuffer->GetAduSize()),
-                               [weak, modbusBuffer](asio::error_code ec, size_t size) {
-                                 Ptr self = weak.lock();
-                                 if (!self) {
-                                   MG_WARN("ModbusRtuSlave::write: actor was deleted");
-                                   return;
-                                 }
-
-                                 if (ec) {
-                                   MG_WARN("ModbusRtuSlave({})::write: error: {}", self->id_, ec.message());
-                                   return;
-                                 }
+  if (writeQueue_.Push(modbusBuffer)) {
+    WriteNext();
+  }
+}
 
-                                 MG_TRACE("ModbusRtuSlave({})::write: {} bytes", self->id_, size);
-                               });
+template<modbus::FrameType frameType>
+void BasicModbusRtuSlave<frameType>::WriteNext() {
+  // frames are written one by one, every frame is written completely
+  Weak weak = this->GetWeak();
+  asio::async_write(serialPort_, writeQueue_.StartBatch(),
+                    MakeAllocHandler(writeMemory_, [weak](asio::error_code ec, size_t size) {
+                      Ptr self = weak.lock();
+                      if (!self) {
+                        MG_WARN("ModbusRtuSlave::write: actor was deleted");
+                        return;
+                      }
+
+                      if (ec) {
+                        MG_WARN("ModbusRtuSlave({})::write: error: {}", self->id_, ec.message());
+                        self->writeQueue_.Reset();
+                        return;
+                      }
+
+                      MG_TRACE("ModbusRtuSlave({})::write: {} bytes", self->id_, size);
+                      if (self->writeQueue_.CompleteBatch()) {
+                        self->WriteNext();
+                      }
+                    }));
 }
 
-ModbusBufferPtr ModbusRtuSlave::MakeResponse(const ModbusMessagePtr &modbusMessage) {
+template<modbus::FrameType frameType>
+ModbusBufferPtr BasicModbusRtuSlave<frameType>::MakeResponse(const ModbusMessagePtr &modbusMessage) {
   const ModbusMessageInfo &messageInfo = modbusMessage->GetModbusMessageInfo();
   ModbusBufferPtr modbusBuffer = modbusMessage->GetModbusBuffer();
 
@@ -200,26 +260,22 @@ ModbusBufferPtr ModbusRtuSlave::MakeResponse(const ModbusMessagePtr &modbusMessa
     return nullptr;
   }
 
-  {
-    auto access = syncRequestInfo_.GetAccess();
-    ModbusMessageInfoOpt &modbusMessageInfoOpt = access.ref;
-    if (!modbusMessageInfoOpt.has_value()) {
-      MG_ERROR(
-          "ModbusRtuSlave({})::MakeResponse: last message info is empty, message transaction id {}",
-          id_,
-          messageInfo.GetTransactionId());
-      return nullptr;
-    }
-    const ModbusMessageInfo &lastInfo = modbusMessageInfoOpt.value();
-    if (lastInfo.GetTransactionId() != messageInfo.GetTransactionId()) {
-      MG_ERROR(
-          "ModbusRtuSlave({})::MakeResponse: message transaction id {} not equal last transaction id {}",
-          id_,
-          messageInfo.GetTransactionId(), lastInfo.GetTransactionId());
-      return nullptr;
-    }
-    modbusMessageInfoOpt.reset();
+  if (!requestInfo_.has_value()) {
+    MG_ERROR(
+        "ModbusRtuSlave({})::MakeResponse: last message info is empty, message transaction id {}",
+        id_,
+        messageInfo.GetTransactionId());
+    return nullptr;
   }
+  const ModbusMessageInfo &lastInfo = requestInfo_.value();
+  if (lastInfo.GetTransactionId() != messageInfo.GetTransactionId()) {
+    MG_ERROR(
+        "ModbusRtuSlave({})::MakeResponse: message transaction id {} not equal last transaction id {}",
+        id_,
+        messageInfo.GetTransactionId(), lastInfo.GetTransactionId());
+    return nullptr;
+  }
+  requestInfo_.reset();
 
   if (!modbusBuffer) {
     MG_CRIT("ModbusRtuSlave({})::MakeResponse: modbus buffer is null. transaction id {}", id_,
@@ -228,19 +284,19 @@ ModbusBufferPtr ModbusRtuSlave::MakeResponse(const ModbusMessagePtr &modbusMessa
   }
 
   const auto originType = modbusBuffer->GetType();
-  modbusBuffer->ConvertTo(frameType_);
-
-  auto wrapper = modbus::MakeModbusBufferWrapper(*modbusBuffer);
-  wrapper->Update();
+  ConvertFrame<frameType>(*modbusBuffer);
 
   MG_DEBUG("ModbusRtuSlave({})::MakeResponse: frame type {}->{}, transaction Id {}",
            id_,
            static_cast<int>(originType),
-           static_cast<int>(frameType_),
+           static_cast<int>(frameType),
            static_cast<int>(messageInfo.GetTransactionId()));
   MG_DEBUG("ModbusRtuSlave({})::MakeResponse: response: [{:X}]", id_, fmt::join(*modbusBuffer, " "));
 
   return modbusBuffer;
 }
 
-}// namespace modbus_gateway
\ No newline at end of file
+template class BasicModbusRtuSlave<modbus::FrameType::RTU>;
+template class BasicModbusRtuSlave<modbus::FrameType::ASCII>;
+
+}// namespace modbus_gateway
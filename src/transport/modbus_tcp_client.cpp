@@ -1,25 +1,87 @@
 #include <transport/modbus_tcp_client.h>
 
 #include <common/logger.h>
+#include <transport/frame_converter.h>
+#include <transport/modbus_exception.h>
 #include <modbus/modbus_buffer_tcp_wrapper.h>
 
 namespace modbus_gateway {
 
+// Send request and receive response as one stackless coroutine on socket strand,
+// timer runs beside and cancels receive on timeout
+class ModbusTcpClient::TransactionOp : asio::coroutine {
+public:
+  TransactionOp(const Weak &weak, const HandlerMemoryPtr &memory, const ModbusBufferPtr &modbusBuffer)
+      : weak_(weak), memory_(memory), modbusBuffer_(modbusBuffer) {}
+
+  void operator()(asio::error_code ec = {}, size_t size = 0) {
+    Ptr self = weak_.lock();
+    if (!self) {
+      MG_WARN("ModbusTcpClient::transaction: actor was deleted")
+      return;
+    }
+
+    ASIO_CORO_REENTER(*this) {
+      ASIO_CORO_YIELD self->socket_->async_send(
+          asio::buffer(modbusBuffer_->begin().base(), modbusBuffer_->GetAduSize()), std::move(*this));
+      if (ec) {
+        self->FailCurrentMessageUnsafe();
+        self->state_ = State::Connected;
+        if (asio::error::operation_aborted != ec) {
+          MG_INFO("ModbusTcpClient({})::send: close connection", self->id_);
+          self->state_ = State::Idle;
+          self->CloseSocket();
+        }
+        MG_ERROR("ModbusTcpClient({})::send: error {}", self->id_, ec.message());
+        self->QueueProcessUnsafe();
+        return;
+      }
+      MG_TRACE("ModbusTcpClient({})::send: send {} bytes", self->id_, size);
+
+      self->StartWaitTask();
+      modbusBuffer_ = MakeModbusBuffer(modbus::FrameType::TCP);
+      ASIO_CORO_YIELD self->socket_->async_receive(
+          asio::buffer(modbusBuffer_->begin().operator->(), modbusBuffer_->GetAduSize()), std::move(*this));
+      self->ReceiveComplete(modbusBuffer_, ec, size);
+    }
+  }
+
+  using allocator_type = HandlerAllocator<void>;
+
+  allocator_type get_allocator() const noexcept {
+    return allocator_type(memory_);
+  }
+
+private:
+  Weak weak_;
+  HandlerMemoryPtr memory_;
+  ModbusBufferPtr modbusBuffer_;
+};
+
 ModbusTcpClient::ModbusTcpClient(const exchange::ExchangePtr &exchange,
                                  const ContextPtr &context,
+                                 const TimerWheelPtr &timerWheel,
                                  const asio::ip::address &addr,
                                  asio::ip::port_type port,
-                                 std::chrono::milliseconds timeout)
+                                 std::chrono::milliseconds timeout,
+                                 const SocketOptions &socketOptions)
     : id_(exchange::defaultId),
       exchange_(exchange),
-      socket_(std::make_unique<TcpSocketPtr::element_type>(*context)),
+      socket_(std::make_unique<StrandTcpSocket>(asio::make_strand(*context))),
       ep_(addr, port),
       timeout_(timeout),
-      timer_(socket_->get_executor()),
-      m_(), messageQueue_(),
+      socketOptions_(socketOptions),
+      timerWheel_(timerWheel),
+      deadline_(),
+      mailbox_(mailboxCapacity),
+      messageQueue_(exchange, timerWheel, timeout, profile::queueDepth, DropPolicy::DropOldest),
       currentMessage_(std::nullopt),
       transactionIdGenerator_(0),
-      state_(State::Idle) {
+      state_(State::Idle),
+      delivery_(Delivery::Post),
+      transactionMemory_(std::make_shared<HandlerMemory>()),
+      connectMemory_(std::make_shared<HandlerMemory>()) {
+  assert(timerWheel_);
   MG_DEBUG("ModbusTcpClient({})::Ctor: {}:{}", id_, addr.to_string(), port);
 }
 
@@ -29,10 +91,27 @@ ModbusTcpClient::~ModbusTcpClient() {
 }
 
 void ModbusTcpClient::Receive(const exchange::MessagePtr &message) {
-  auto modbusMessage = std::dynamic_pointer_cast<ModbusMessagePtr::element_type>(message);
+  auto modbusMessage = MessageCast<ModbusMessage>(message);
   if (modbusMessage) {
     MG_TRACE("ModbusTcpClient({})::Receive: ModbusMessage", id_);
-    MessageProcess(modbusMessage);
+    bool wake = false;
+    if (!mailbox_.Push(modbusMessage, wake)) {
+      MG_ERROR("ModbusTcpClient({})::Receive: mailbox is full", id_);
+      RejectMessage(modbusMessage, ModbusExceptionCode::ServerDeviceBusy);
+      return;
+    }
+    if (wake) {
+      // mailbox was empty, consumer is not scheduled
+      Weak weak = GetWeak();
+      Deliver(delivery_, socket_->get_executor(), [weak]() {
+        Ptr self = weak.lock();
+        if (!self) {
+          MG_WARN("ModbusTcpClient::receive: actor was deleted")
+          return;
+        }
+        self->MailboxProcess();
+      });
+    }
     return;
   }
   MG_WARN("ModbusTcpClient({})::Receive: unsupported message", id_);
@@ -50,11 +129,40 @@ exchange::ActorId ModbusTcpClient::GetId() {
   return id_;
 }
 
-void ModbusTcpClient::MessageProcess(const ModbusMessagePtr &message) {
-  std::lock_guard<std::mutex> lock(m_);
-  messageQueue_.Push(message);
-  MG_TRACE("ModbusTcpClient({})::MessageProcess: message in queue {}", id_, messageQueue_.Size());
+void ModbusTcpClient::SetDelivery(Delivery delivery) {
+  delivery_ = delivery;
+}
+
+void ModbusTcpClient::SetQueue(size_t size, DropPolicy dropPolicy) {
+  messageQueue_ = RequestQueue(exchange_, timerWheel_, timeout_, profile::Clamp(size, profile::queueDepth), dropPolicy);
+}
+
+void ModbusTcpClient::MailboxProcess() {
+  ModbusMessagePtr message;
+  bool more = true;
+  while (more && mailbox_.Pop(message)) {
+    const auto dropped = messageQueue_.Push(message);
+    if (dropped) {
+      RejectMessage(dropped, ModbusExceptionCode::ServerDeviceBusy);
+    }
+    message.reset();
+    more = mailbox_.Release();
+  }
+  MG_TRACE("ModbusTcpClient({})::MailboxProcess: message in queue {}", id_, messageQueue_.Size());
   QueueProcessUnsafe();
+
+  if (more) {
+    // next message is not published by producer yet
+    Weak weak = GetWeak();
+    asio::post(socket_->get_executor(), [weak]() {
+      Ptr self = weak.lock();
+      if (!self) {
+        MG_WARN("ModbusTcpClient::mailbox: actor was deleted")
+        return;
+      }
+      self->MailboxProcess();
+    });
+  }
 }
 
 void ModbusTcpClient::QueueProcessUnsafe() {
@@ -84,15 +192,13 @@ void ModbusTcpClient::QueueProcessUnsafe() {
 void ModbusTcpClient::StartConnectTaskUnsafe() {
   MG_INFO("ModbusTcpClient({})::StartConnectTask: connect to {}:{}", id_, ep_.address().to_string(), ep_.port());
   Weak weak = GetWeak();
-  socket_->async_connect(ep_, [weak](asio::error_code ec) {
+  socket_->async_connect(ep_, MakeAllocHandler(connectMemory_, [weak](asio::error_code ec) {
     Ptr self = weak.lock();
     if (!self) {
       MG_WARN("ModbusTcpClient::connect: actor was deleted")
       return;
     }
 
-    std::lock_guard<std::mutex> lock(self->m_);
-
     if (ec) {
       self->state_ = State::Idle;
 
@@ -105,12 +211,12 @@ void ModbusTcpClient::StartConnectTaskUnsafe() {
     }
 
     self->state_ = State::Connected;
+    SetOptions(*self->socket_, self->socketOptions_);
 
     MG_INFO("ModbusTcpClient({})::connect: connect to {}:{} successful", self->id_,
-            self->socket_->remote_endpoint().address().to_string(),
-            self->socket_->remote_endpoint().port());
+            self->ep_.address().to_string(), self->ep_.port());
     self->QueueProcessUnsafe();
-  });
+  }));
 }
 
 void ModbusTcpClient::StartMessageTaskUnsafe() {
@@ -119,34 +225,20 @@ void ModbusTcpClient::StartMessageTaskUnsafe() {
     return;
   }
 
-  while (!messageQueue_.Empty()) {
-    const auto &message = messageQueue_.Front();
-    if (!message->GetModbusMessageInfo().TimeoutReached(timeout_)) {
-      break;
-    }
-
-    const auto &messageInfo = message->GetModbusMessageInfo();
-    MG_INFO(
-        "ModbusTcpClient({})::StartMessageTask: message reached timeout {}, message id {}, source id {}", id_,
-        timeout_.count(), messageInfo.GetTransactionId(), messageInfo.GetSourceId());
-    messageQueue_.Pop();
-  }
-
-  if (messageQueue_.Empty()) {
+  ModbusMessagePtr message;
+  if (!messageQueue_.Pop(message)) {
     MG_INFO("ModbusTcpClient({})::StartMessageTask: message queue empty", id_);
     return;
   }
 
   state_ = State::MessageProcess;
-  currentMessage_ = {messageQueue_.Front(), ++transactionIdGenerator_};
-  messageQueue_.Pop();
+  currentMessage_ = {message, ++transactionIdGenerator_};
 
   ModbusBufferPtr modbusBuffer = currentMessage_->modbusMessage->GetModbusBuffer();
   const auto originType = modbusBuffer->GetType();
-  modbusBuffer->ConvertTo(modbus::FrameType::TCP);
+  ConvertFrame(*modbusBuffer, modbus::FrameType::TCP);
   {
     modbus::ModbusBufferTcpWrapper modbusBufferTcpWrapper(*modbusBuffer);
-    modbusBufferTcpWrapper.Update();
     modbusBufferTcpWrapper.SetTransactionId(currentMessage_->id);
 
     MG_DEBUG("ModbusTcpClient({})::StartMessageTask: frame type {}->{}, actor id {}, transaction Id {}->{}",
@@ -160,64 +252,103 @@ void ModbusTcpClient::StartMessageTaskUnsafe() {
     MG_DEBUG("ModbusTcpClient({})::StartMessageTask: request: [{:X}]", id_, fmt::join(*modbusBuffer, " "));
   }
 
-  Weak weak = GetWeak();
-  socket_->async_send(asio::buffer(modbusBuffer->begin().base(), modbusBuffer->GetAduSize()),
-                      [weak](asio::error_code ec, size_t size) {
-                        Ptr self = weak.lock();
-                        if (!self) {
-                          MG_WARN("ModbusTcpClient::send: actor was deleted")
-                          return;
-                        }
-
-                        std::lock_guard<std::mutex> lock(self->m_);
-
-                        if (ec) {
-                          self->currentMessage_.reset();
-                          self->state_ = State::Connected;
-                          if (asio::error::operation_aborted != ec) {
-                            MG_INFO("ModbusTcpClient({})::send: close connection", self->id_);
-                            self->state_ = State::Idle;
-                            self->CloseSocket();
-                          }
-                          MG_ERROR("ModbusTcpClient({})::send: error {}", self->id_, ec.message());
-                          return;
-                        }
-
-                        MG_TRACE("ModbusTcpClient({})::send: send {} bytes", self->id_, size);
-                        self->StartWaitTask();
-                        self->StartReceiveTask();
-                      });
+  TransactionOp(GetWeak(), transactionMemory_, modbusBuffer)();
 }
 
 void ModbusTcpClient::StartWaitTask() {
   MG_TRACE("ModbusTcpClient({})::StartWaitTask timeout {}ms", id_, timeout_.count());
-  timer_.expires_after(timeout_);
+  const auto id = currentMessage_->id;
 
   Weak weak = GetWeak();
-  timer_.async_wait([weak](asio::error_code ec) {
+  deadline_ = timerWheel_->Arm(timeout_, [weak, id]() {
     Ptr self = weak.lock();
     if (!self) {
       MG_WARN("ModbusTcpClient::wait: actor was deleted");
       return;
     }
-
-    std::lock_guard<std::mutex> lock(self->m_);
-
-    if (ec) {
-      if (asio::error::operation_aborted == ec) {
-        MG_TRACE("ModbusTcpClient({})::wait: canceled", self->id_);
+    // timer wheel callback runs on wheel strand
+    asio::post(self->socket_->get_executor(), [weak, id]() {
+      Ptr self = weak.lock();
+      if (!self) {
+        MG_WARN("ModbusTcpClient::wait: actor was deleted");
         return;
       }
-      MG_ERROR("ModbusTcpClient({})::wait: error: {}", self->id_, ec.message())
-      return;
+      self->WaitComplete(id);
+    });
+  });
+}
+
+void ModbusTcpClient::WaitComplete(modbus::TransactionId id) {
+  if (!currentMessage_.has_value() || currentMessage_->id != id) {
+    MG_TRACE("ModbusTcpClient({})::wait: transaction {} already completed", id_, id);
+    return;
+  }
+
+  MG_ERROR("ModbusTcpClient({})::wait: achieve timeout, cancel receive task", id_);
+  asio::error_code ec;
+  ec = socket_->cancel(ec);
+  if (ec) {
+    MG_WARN("ModbusTcpClient({})::wait: socket cancel error: {}", id_, ec.message());
+  }
+}
+
+void ModbusTcpClient::ReceiveComplete(const ModbusBufferPtr &modbusBuffer, asio::error_code ec, size_t size) {
+  auto exchange = exchange_.lock();
+  if (!exchange) {
+    MG_WARN("ModbusTcpClient({})::receive: exchange was deleted", id_);
+    return;
+  }
+
+  if (!timerWheel_->Cancel(deadline_)) {
+    MG_DEBUG("ModbusTcpClient({})::receive: deadline already reached", id_);
+  }
+
+  if (ec) {
+    FailCurrentMessageUnsafe();
+    state_ = State::Connected;
+    if (asio::error::operation_aborted != ec) {
+      MG_INFO("ModbusTcpClient({})::receive: close connection", id_);
+      state_ = State::Idle;
+      CloseSocket();
+    } else {
+      MG_ERROR("ModbusTcpClient({})::receive: error: {}", id_, ec.message());
     }
+    // queued requests go on, closed connection is opened again
+    QueueProcessUnsafe();
+    return;
+  }
 
-    MG_ERROR("ModbusTcpClient({})::wait: achieve timeout, cancel receive task", self->id_);
-    ec = self->socket_->cancel(ec);
-    if (ec) {
-      MG_WARN("ModbusTcpClient({})::wait: socket cancel error: {}", self->id_, ec.message());
+  MG_TRACE("ModbusTcpClient({})::receive: receive {} bytes", id_, size);
+  if (socketOptions_.quickAck.value_or(false)) {
+    RearmQuickAck(*socket_);
+  }
+
+  const auto modbusMessage = MakeResponse(modbusBuffer, size);
+  if (modbusMessage) {
+    const auto actorId = modbusMessage->GetModbusMessageInfo().GetSourceId();
+    const auto res = exchange->Send(actorId, modbusMessage);
+    if (!res) {
+      MG_ERROR("ModbusTcpClient({})::receive: send to actorId {} failed", id_, actorId);
     }
-  });
+  }
+
+  state_ = State::Connected;
+  QueueProcessUnsafe();
+}
+
+void ModbusTcpClient::RejectMessage(const ModbusMessagePtr &message, ModbusExceptionCode code) {
+  const ModbusMessageInfo &messageInfo = message->GetModbusMessageInfo();
+  MG_WARN("ModbusTcpClient({})::RejectMessage: drop message id {}, source id {}", id_, messageInfo.GetTransactionId(),
+          messageInfo.GetSourceId());
+  RejectRequest(exchange_, message, code);
+}
+
+void ModbusTcpClient::FailCurrentMessageUnsafe() {
+  if (!currentMessage_.has_value()) {
+    return;
+  }
+  RejectMessage(currentMessage_->modbusMessage, ModbusExceptionCode::GatewayTargetFailed);
+  currentMessage_.reset();
 }
 
 ModbusMessagePtr ModbusTcpClient::MakeResponse(const ModbusBufferPtr &modbusBuffer, size_t size) {
@@ -259,66 +390,7 @@ ModbusMessagePtr ModbusTcpClient::MakeResponse(const ModbusBufferPtr &modbusBuff
            currentInfo.GetSourceId(),
            id,
            currentInfo.GetTransactionId());
-  return ModbusMessage::Create(currentInfo, modbusBuffer);
-}
-
-void ModbusTcpClient::StartReceiveTask() {
-  MG_TRACE("ModbusTcpClient({})::StartReceiveTask", id_);
-
-  auto modbusBuffer = std::make_shared<modbus::ModbusBuffer>(modbus::FrameType::TCP);
-  Weak weak = GetWeak();
-  socket_->async_receive(asio::buffer(modbusBuffer->begin().operator->(), modbusBuffer->GetAduSize()),
-                         [weak, modbusBuffer](asio::error_code ec, size_t size) {
-                           Ptr self = weak.lock();
-                           if (!self) {
-                             MG_WARN("ModbusTcpClient::receive: actor was deleted")
-                             return;
-                           }
-
-                           auto exchange = self->exchange_.lock();
-                           if (!exchange) {
-                             MG_WARN("ModbusTcpClient({})::accept: exchange was deleted");
-                             return;
-                           }
-
-                           std::lock_guard<std::mutex> lock(self->m_);
-
-                           try {
-                             const auto tp = self->timer_.expiry() - std::chrono::steady_clock::now();
-                             const auto exp = tp.count() / std::chrono::microseconds::period::den;
-                             MG_DEBUG("ModbusTcpClient({})::receive: left {}ms", self->id_, exp);
-                             self->timer_.cancel();
-                           } catch (const asio::system_error &e) {
-                             MG_ERROR("ModbusTcpClient({})::receive: timer cancel error: {}", self->id_, ec.message());
-                           }
-
-                           if (ec) {
-                             self->currentMessage_.reset();
-                             self->state_ = State::Connected;
-                             if (asio::error::operation_aborted != ec) {
-                               MG_INFO("ModbusTcpClient({})::receive: close connection", self->id_);
-                               self->state_ = State::Idle;
-                               self->CloseSocket();
-                               return;
-                             }
-                             MG_ERROR("ModbusTcpClient({})::receive: error: {}", self->id_, ec.message());
-                             return;
-                           }
-
-                           MG_TRACE("ModbusTcpClient({})::receive: receive {} bytes", self->id_, size);
-
-                           const auto modbusMessage = self->MakeResponse(modbusBuffer, size);
-                           if (modbusMessage) {
-                             const auto actorId = modbusMessage->GetModbusMessageInfo().GetSourceId();
-                             const auto res = exchange->Send(actorId, modbusMessage);
-                             if(!res){
-                               MG_ERROR("ModbusTcpClient({})::receive: send to actorId {} failed", self->id_, actorId);
-                             }
-                           }
-
-                           self->state_ = State::Connected;
-                           self->QueueProcessUnsafe();
-                         });
+  return MakeModbusMessage(currentInfo, modbusBuffer);
 }
 
 std::string ModbusTcpClient::StateToStr(State state) {
@@ -3,6 +3,9 @@
 #include <common/logger.h>
 #include <message/client_disconnect_message.h>
 #include <message/modbus_message.h>
+#include <transport/frame_converter.h>
+#include <transport/modbus_exception.h>
+#include <transport/socket_options.h>
 
 #include <modbus/modbus_buffer.h>
 #include <modbus/modbus_buffer_tcp_wrapper.h>
@@ -11,10 +14,57 @@ using namespace asio;
 
 namespace modbus_gateway {
 
+// Receive loop as stackless coroutine on socket strand
+class ModbusTcpConnection::ReceiveOp : asio::coroutine {
+public:
+  ReceiveOp(const Weak &weak, const HandlerMemoryPtr &memory)
+      : weak_(weak), memory_(memory) {}
+
+  void operator()(error_code ec = {}, size_t size = 0) {
+    Ptr self = weak_.lock();
+    if (!self) {
+      MG_WARN("ModbusTcpConnection::receive: actor was deleted");
+      return;
+    }
+
+    ASIO_CORO_REENTER(*this) {
+      for (;;) {
+        if (self->paused_) {
+          // client is slowed down by tcp flow control while socket is not read
+          self->paused_ = false;
+          self->pauseTimer_.expires_after(pauseTime);
+          ASIO_CORO_YIELD self->pauseTimer_.async_wait(std::move(*this));
+          // requests received before pause are processed first, client may wait for their responses
+          size = 0;
+        } else {
+          ASIO_CORO_YIELD self->socket_->async_receive(self->mbapReassembler_.Prepare(), std::move(*this));
+        }
+        if (!self->ReceiveComplete(ec, size)) {
+          return;
+        }
+      }
+    }
+  }
+
+  using allocator_type = HandlerAllocator<void>;
+
+  allocator_type get_allocator() const noexcept {
+    return allocator_type(memory_);
+  }
+
+private:
+  Weak weak_;
+  HandlerMemoryPtr memory_;
+};
+
 ModbusTcpConnection::ModbusTcpConnection(const exchange::ExchangePtr &exchange, exchange::ActorId serverId,
-                                         TcpSocketPtr socket, const RouterPtr &router)
-    : id_(exchange::defaultId), exchange_(exchange), serverId_(serverId), socket_(std::move(socket)), router_(router),
-      syncRequestInfo_(std::nullopt) {
+                                         StrandTcpSocketPtr socket, const TcpEndpoint &remoteEndpoint,
+                                         const RouterPtr &router)
+    : id_(exchange::defaultId), exchange_(exchange), serverId_(serverId), socket_(std::move(socket)),
+      remoteEndpoint_(remoteEndpoint), lastActivity_(std::chrono::steady_clock::now().time_since_epoch().count()), router_(router),
+      mbapReassembler_(receiveBufferSize), inflight_(profile::maxInflight, InflightTable::defaultTimeout), delivery_(Delivery::Post),
+      receiveMemory_(std::make_shared<HandlerMemory>()), sendMemory_(std::make_shared<HandlerMemory>()), writeQueue_(sendBatch, writeCapacity), memoryBudget_(nullptr), pauseTimer_(socket_->get_executor()),
+      paused_(false), quickAck_(false) {
   assert(socket_);
   assert(router_);
   MG_DEBUG("ModbusTcpConnection({})::Ctor: serverId {}", id_, serverId_);
@@ -22,8 +72,11 @@ ModbusTcpConnection::ModbusTcpConnection(const exchange::ExchangePtr &exchange,
 
 ModbusTcpConnection::~ModbusTcpConnection() {
   MG_DEBUG("ModbusTcpConnection({})::Dtor", id_);
-  Stop();
   error_code ec;
+  ec = socket_->cancel(ec);
+  if (ec) {
+    MG_WARN("ModbusTcpConnection({})::Dtor: socket cancel error: {}", id_, ec.message());
+  }
   ec = socket_->shutdown(socket_base::shutdown_both, ec);
   if (ec) {
     MG_WARN("ModbusTcpConnection({})::Dtor: socket shutdown error: {}", id_, ec.message());
@@ -35,10 +88,18 @@ ModbusTcpConnection::~ModbusTcpConnection() {
 }
 
 void ModbusTcpConnection::Receive(const exchange::MessagePtr &message) {
-  const ModbusMessagePtr &modbusMessage = std::dynamic_pointer_cast<ModbusMessagePtr::element_type>(message);
+  const ModbusMessagePtr modbusMessage = MessageCast<ModbusMessage>(message);
   if (modbusMessage) {
     MG_TRACE("ModbusTcpConnection({})::Receive: ModbusMessage", id_);
-    StartSendTask(modbusMessage);
+    Weak weak = GetWeak();
+    Deliver(delivery_, socket_->get_executor(), [weak, modbusMessage]() {
+      Ptr self = weak.lock();
+      if (!self) {
+        MG_WARN("ModbusTcpConnection::receive: actor was deleted");
+        return;
+      }
+      self->StartSendTask(modbusMessage);
+    });
     return;
   }
   MG_WARN("ModbusTcpConnection({})::Receive: unsupported message", id_);
@@ -56,22 +117,61 @@ exchange::ActorId ModbusTcpConnection::GetId() {
   return id_;
 }
 
+void ModbusTcpConnection::SetDelivery(Delivery delivery) {
+  delivery_ = delivery;
+}
+
+void ModbusTcpConnection::SetMemoryBudget(const MemoryBudgetPtr &memoryBudget) {
+  memoryBudget_ = memoryBudget;
+}
+
+void ModbusTcpConnection::SetMaxInflight(size_t maxInflight) {
+  inflight_ = InflightTable(profile::Clamp(maxInflight, profile::maxInflight), inflight_.Timeout());
+}
+
+void ModbusTcpConnection::SetInflightTimeout(std::chrono::milliseconds timeout) {
+  inflight_ = InflightTable(inflight_.Depth(), timeout);
+}
+
+void ModbusTcpConnection::SetQuickAck(bool quickAck) {
+  quickAck_ = quickAck;
+}
+
 void ModbusTcpConnection::Start() {
   assert(id_ != exchange::defaultId);
   MG_INFO("ModbusTcpConnection({})::Start: serverId {}, client {}:{}",
           id_, serverId_,
-          socket_->remote_endpoint().address().to_string(),
-          socket_->remote_endpoint().port())
+          remoteEndpoint_.address().to_string(), remoteEndpoint_.port())
   StartReceiveTask();
 }
 
 void ModbusTcpConnection::Stop() {
   MG_INFO("ModbusTcpConnection({})::Stop", id_);
-  error_code ec;
-  ec = socket_->cancel(ec);
-  if (ec) {
-    MG_WARN("ModbusTcpConnection({})::Stop socket cancel error: {}", id_, ec.message());
-  }
+  Weak weak = GetWeak();
+  dispatch(socket_->get_executor(), [weak]() {
+    Ptr self = weak.lock();
+    if (!self) {
+      return;
+    }
+    error_code ec;
+    ec = self->socket_->cancel(ec);
+    if (ec) {
+      MG_WARN("ModbusTcpConnection({})::Stop socket cancel error: {}", self->id_, ec.message());
+    }
+    self->pauseTimer_.cancel();
+  });
+}
+
+std::chrono::steady_clock::time_point ModbusTcpConnection::GetLastActivity() const {
+  return std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(lastActivity_.load(std::memory_order_relaxed)));
+}
+
+asio::ip::address ModbusTcpConnection::GetRemoteAddress() const {
+  return remoteEndpoint_.address();
+}
+
+void ModbusTcpConnection::UpdateActivity() {
+  lastActivity_.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
 }
 
 ModbusMessagePtr
@@ -91,62 +191,115 @@ ModbusTcpConnection::MakeRequest(const ModbusBufferPtr &modbusBuffer, size_t siz
   MG_DEBUG("ModbusTcpConnection({})::MakeRequest: transaction id {}", masterId, modbusBufferTcpWrapper.GetTransactionId());
   // Save origin message id to message info, restore this id in MakeRequest
   ModbusMessageInfo modbusMessageInfo(masterId, modbusBufferTcpWrapper.GetTransactionId());
-  return std::make_shared<ModbusMessagePtr::element_type>(modbusMessageInfo, modbusBuffer);
+  return MakeModbusMessage(modbusMessageInfo, modbusBuffer);
 }
 
 void ModbusTcpConnection::StartReceiveTask() {
-  MG_TRACE("ModbusTcpConnection({})::StartReadTask", id_);
-  Weak weak = GetWeak();
-  auto modbusBuffer = std::make_shared<modbus::ModbusBuffer>(modbus::FrameType::TCP);
-  socket_->async_receive(buffer(modbusBuffer->begin().operator->(), modbusBuffer->GetAduSize()),
-                         [weak, modbusBuffer](error_code ec, size_t size) {
-                           Ptr self = weak.lock();
-                           if (!self) {
-                             MG_WARN("ModbusTcpConnection::receive: actor was deleted");
-                             return;
-                           }
-
-                           auto exchange = self->exchange_.lock();
-                           if (!exchange) {
-                             MG_WARN("ModbusTcpConnection({})::accept: exchange was deleted");
-                             return;
-                           }
-
-                           if (ec) {
-                             if ((error::eof == ec) || (error::connection_reset == ec) || (error::operation_aborted == ec)) {
-                               MG_INFO("ModbusTcpConnection({})::receive: send disconnect message, {}",
-                                       self->id_, ec.message());
-                               exchange->Send(self->serverId_, ClientDisconnectMessage::Create(self->id_));
-                               return;
-                             }
-                             MG_ERROR("ModbusTcpConnection({})::receive: error: {}", self->id_, ec.message())
-                             self->StartReceiveTask();
-                             return;
-                           }
-
-                           MG_TRACE("ModbusTcpConnection({})::receive: {} bytes", self->id_, size);
-                           auto message = self->MakeRequest(modbusBuffer, size, self->id_);
-                           if (!message) {
-                             MG_ERROR("ModbusTcpConnection: receive: invalid request, start receive task");
-                             self->StartReceiveTask();
-                             return;
-                           }
-
-                           {
-                             auto access = self->syncRequestInfo_.GetAccess();
-                             access.ref = message->GetModbusMessageInfo();
-                           }
-
-                           const modbus::UnitId unitId = message->GetModbusBuffer()->GetUnitId();
-                           const exchange::ActorId actorId = self->router_->Route(unitId);
-                           MG_DEBUG("ModbusTcpConnection({})::receive: unit id {} route to actor id {}",
-                                    self->id_, unitId, actorId);
-                           const auto res = exchange->Send(actorId, message);
-                           if (!res) {
-                             MG_ERROR("ModbusTcpConnection({})::receive: send to actor id {} failed", self->id_, actorId);
-                           }
-                           self->StartReceiveTask();
-                         });
+  MG_TRACE("ModbusTcpConnection({})::StartReceiveTask", id_);
+  ReceiveOp{GetWeak(), receiveMemory_}();
+}
+
+bool ModbusTcpConnection::ReceiveComplete(error_code ec, size_t size) {
+  auto exchange = exchange_.lock();
+  if (!exchange) {
+    MG_WARN("ModbusTcpConnection({})::receive: exchange was deleted", id_);
+    return false;
+  }
+
+  if (ec) {
+    if ((error::eof == ec) || (error::connection_reset == ec) || (error::operation_aborted == ec)) {
+      MG_INFO("ModbusTcpConnection({})::receive: send disconnect message, {}", id_, ec.message());
+      exchange->Send(serverId_, ClientDisconnectMessage::Create(id_));
+      return false;
+    }
+    MG_ERROR("ModbusTcpConnection({})::receive: error: {}", id_, ec.message())
+    return true;
+  }
+
+  if (0 != size) {
+    MG_TRACE("ModbusTcpConnection({})::receive: {} bytes", id_, size);
+    UpdateActivity();
+    if (quickAck_) {
+      RearmQuickAck(*socket_);
+    }
+    mbapReassembler_.Commit(size);
+  }
+
+  // one segment may carry several requests
+  for (;;) {
+    if (writeQueue_.Full()) {
+      // client does not read responses, next requests wait in ring and in socket
+      MG_WARN("ModbusTcpConnection({})::receive: {} responses wait for write, pause receive", id_, writeQueue_.Size());
+      paused_ = true;
+      return true;
+    }
+    size_t aduSize = 0;
+    switch (mbapReassembler_.Next(aduSize)) {
+    case MbapReassembler::Result::NeedMore:
+      return true;
+    case MbapReassembler::Result::Invalid:
+      // stream is out of sync, next frame boundary is unknown
+      MG_ERROR("ModbusTcpConnection({})::receive: invalid mbap header, drop {} received bytes, send disconnect message",
+               id_, mbapReassembler_.Size());
+      mbapReassembler_.Reset();
+      exchange->Send(serverId_, ClientDisconnectMessage::Create(id_));
+      return false;
+    case MbapReassembler::Result::Complete:
+      break;
+    }
+    ModbusBufferPtr modbusBuffer = MakeModbusBuffer(modbus::FrameType::TCP);
+    mbapReassembler_.Take(modbusBuffer->begin().operator->(), aduSize);
+    if (!ProcessRequest(exchange, modbusBuffer, aduSize)) {
+      // next requests wait in ring until pause ends instead of being rejected one by one
+      paused_ = true;
+      return true;
+    }
+  }
+}
+
+bool ModbusTcpConnection::ProcessRequest(const exchange::ExchangePtr &exchange, const ModbusBufferPtr &modbusBuffer,
+                                         size_t size) {
+  auto message = MakeRequest(modbusBuffer, size, id_);
+  if (!message) {
+    MG_ERROR("ModbusTcpConnection({})::receive: invalid request", id_);
+    return true;
+  }
+
+  if (memoryBudget_) {
+    auto memoryCharge = MemoryCharge::TryMake(memoryBudget_, requestCost);
+    if (!memoryCharge) {
+      MG_WARN("ModbusTcpConnection({})::receive: memory budget exhausted, used {} of {} bytes, reject request", id_,
+              memoryBudget_->Used(), memoryBudget_->Limit());
+      RejectRequest(message);
+      return false;
+    }
+    message->SetMemoryCharge(std::move(memoryCharge));
+  }
+
+  const modbus::TransactionId transactionId = message->GetModbusMessageInfo().GetTransactionId();
+  if (!inflight_.Insert(transactionId)) {
+    MG_WARN("ModbusTcpConnection({})::receive: transaction id {} is in flight or {} of {} transactions in flight, "
+            "reject request", id_, transactionId, inflight_.Size(), inflight_.Depth());
+    RejectRequest(message);
+    return true;
+  }
+
+  const modbus::UnitId unitId = message->GetModbusBuffer()->GetUnitId();
+  const exchange::ActorId actorId = router_->Route(unitId);
+  MG_DEBUG("ModbusTcpConnection({})::receive: unit id {} route to actor id {}", id_, unitId, actorId);
+  const auto res = exchange->Send(actorId, message);
+  if (!res) {
+    MG_ERROR("ModbusTcpConnection({})::receive: send to actor id {} failed", id_, actorId);
+  }
+  return true;
+}
+
+void ModbusTcpConnection::RejectRequest(const ModbusMessagePtr &modbusMessage) {
+  // request is answered here, transaction id of request is kept in buffer
+  const ModbusBufferPtr &modbusBuffer = modbusMessage->GetModbusBuffer();
+  MakeExceptionResponse(*modbusBuffer, ModbusExceptionCode::ServerDeviceBusy);
+  MG_DEBUG("ModbusTcpConnection({})::RejectRequest: response: [{:X}]", id_, fmt::join(*modbusBuffer, " "));
+  SendBuffer(modbusBuffer);
 }
 
 ModbusBufferPtr ModbusTcpConnection::MakeResponse(const ModbusMessagePtr &modbusMessage) {
@@ -160,25 +313,11 @@ ModbusBufferPtr ModbusTcpConnection::MakeResponse(const ModbusMessagePtr &modbus
     return nullptr;
   }
 
-  {
-    auto access = syncRequestInfo_.GetAccess();
-    ModbusMessageInfoOpt &modbusMessageInfoOpt = access.ref;
-    if (!modbusMessageInfoOpt.has_value()) {
-      MG_ERROR(
-          "ModbusTcpConnection({})::MakeResponse: last message info is empty, message transaction id {}",
-          id_,
-          messageInfo.GetTransactionId());
-      return nullptr;
-    }
-    const ModbusMessageInfo &lastInfo = modbusMessageInfoOpt.value();
-    if (lastInfo.GetTransactionId() != messageInfo.GetTransactionId()) {
-      MG_ERROR(
-          "ModbusTcpConnection({})::MakeResponse: message transaction id {} not equal last transaction id {}",
-          id_,
-          messageInfo.GetTransactionId(), lastInfo.GetTransactionId());
-      return nullptr;
-    }
-    modbusMessageInfoOpt.reset();
+  // responses come in order of completion by masters
+  if (!inflight_.Erase(messageInfo.GetTransactionId())) {
+    MG_ERROR("ModbusTcpConnection({})::MakeResponse: transaction id {} is not in flight", id_,
+             messageInfo.GetTransactionId());
+    return nullptr;
   }
 
   if (!modbusBuffer) {
@@ -188,9 +327,8 @@ ModbusBufferPtr ModbusTcpConnection::MakeResponse(const ModbusMessagePtr &modbus
   }
 
   const auto originType = modbusBuffer->GetType();
-  modbusBuffer->ConvertTo(modbus::FrameType::TCP);
+  ConvertFrame(*modbusBuffer, modbus::FrameType::TCP);
   modbus::ModbusBufferTcpWrapper modbusBufferTcpWrapper(*modbusBuffer);
-  modbusBufferTcpWrapper.Update();
   modbusBufferTcpWrapper.SetTransactionId(messageInfo.GetTransactionId());
 
   MG_DEBUG("ModbusTcpConnection({})::MakeResponse: frame type {}->{}, transaction Id {}",
@@ -210,23 +348,38 @@ void ModbusTcpConnection::StartSendTask(const ModbusMessagePtr &modbusMessage) {
   if (!modbusBuffer) {
     return;
   }
+  SendBuffer(modbusBuffer);
+}
 
+void ModbusTcpConnection::SendBuffer(const ModbusBufferPtr &modbusBuffer) {
+  if (writeQueue_.Push(modbusBuffer)) {
+    StartWriteTask();
+  }
+}
+
+void ModbusTcpConnection::StartWriteTask() {
   Weak weak = GetWeak();
-  socket_->async_send(buffer(modbusBuffer->begin().operator->(), modbusBuffer->GetAduSize()),
-                      [weak, modbusBuffer](error_code ec, size_t size) {
-                        Ptr self = weak.lock();
-                        if (!self) {
-                          MG_WARN("ModbusTcpConnection::send: actor was deleted");
-                          return;
-                        }
-
-                        if (ec) {
-                          MG_ERROR("ModbusTcpConnection({})::send: error: {}", self->id_, ec.message());
-                          return;
-                        }
-
-                        MG_TRACE("ModbusTcpConnection({})::send: {} bytes", self->id_, size);
-                      });
+  async_write(*socket_, writeQueue_.StartBatch(), MakeAllocHandler(sendMemory_, [weak](error_code ec, size_t size) {
+    Ptr self = weak.lock();
+    if (!self) {
+      MG_WARN("ModbusTcpConnection::send: actor was deleted");
+      return;
+    }
+
+    if (ec) {
+      MG_ERROR("ModbusTcpConnection({})::send: error: {}, drop {} responses", self->id_, ec.message(),
+               self->writeQueue_.BatchSize());
+      self->writeQueue_.Reset();
+      return;
+    }
+
+    MG_TRACE("ModbusTcpConnection({})::send: {} responses, {} bytes", self->id_, self->writeQueue_.BatchSize(), size);
+    self->UpdateActivity();
+    // responses which are ready during send go in next send
+    if (self->writeQueue_.CompleteBatch()) {
+      self->StartWriteTask();
+    }
+  }));
 }
 
 }// namespace modbus_gateway
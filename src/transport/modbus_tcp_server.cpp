@@ -1,31 +1,99 @@
 #include <transport/modbus_tcp_server.h>
 
+#include <transport/socket_options.h>
+
 #include <common/logger.h>
+#include <common/profile.h>
 #include <message/client_disconnect_message.h>
 
+#include <algorithm>
+#include <limits>
+
 using namespace asio;
 
 namespace modbus_gateway {
 
+namespace {
+
+TcpAcceptor MakeAcceptor(const ContextPtr &context, const TcpEndpoint &endpoint, bool reusePort) {
+  TcpAcceptor acceptor(*context);
+  acceptor.open(endpoint.protocol());
+  acceptor.set_option(TcpAcceptor::reuse_address(true));
+  if (reusePort) {
+#ifdef SO_REUSEPORT
+    acceptor.set_option(ReusePort(true));
+#else
+    throw std::runtime_error("SO_REUSEPORT unsupported");
+#endif
+  }
+  acceptor.bind(endpoint);
+  acceptor.listen();
+  return acceptor;
+}
+
+}// namespace
+
 ModbusTcpServer::ModbusTcpServer(const exchange::ExchangePtr &exchange, const ContextPtr &context,
                                  const asio::ip::address &addr, ip::port_type port,
-                                 const RouterPtr &router)
+                                 const RouterPtr &router, const SocketOptions &socketOptions)
+    : ModbusTcpServer(exchange, std::vector<ContextPtr>{context}, addr, port, router, socketOptions) {
+}
+
+ModbusTcpServer::ModbusTcpServer(const exchange::ExchangePtr &exchange, const std::vector<ContextPtr> &contexts,
+                                 const asio::ip::address &addr, ip::port_type port,
+                                 const RouterPtr &router, const SocketOptions &socketOptions)
     : IModbusSlave(TransportType::TcpServer),
       id_(exchange::defaultId),
       exchange_(exchange),
-      acceptor_(*context, TcpEndpoint(addr, port)),
-      router_(router) {
+      contexts_(contexts),
+      acceptors_(),
+      router_(router),
+      socketOptions_(socketOptions),
+      delivery_(Delivery::Post),
+      memoryBudget_(nullptr),
+      connectionMemoryLimit_(MemoryBudget::unlimited),
+      maxInflight_(profile::maxInflight),
+      inflightTimeout_(InflightTable::defaultTimeout),
+      connectionLimits_(),
+      strand_(make_strand(*contexts.front())),
+      sweepTimer_(strand_),
+      sweeping_(false),
+      accepted_(0),
+      rejected_(0),
+      reaped_(0),
+      evicted_(0) {
   assert(router_);
-  MG_DEBUG("ModbusTcpServer({})::Ctor: {}:{}", id_, addr.to_string(), port);
+  assert(!contexts.empty());
+  const TcpEndpoint endpoint(addr, port);
+  const bool reusePort = contexts.size() > 1;
+  acceptors_.reserve(contexts.size());
+  for (const auto &context : contexts) {
+    acceptors_.push_back(MakeAcceptor(context, endpoint, reusePort));
+  }
+  MG_DEBUG("ModbusTcpServer({})::Ctor: {}:{}, shards {}", id_, addr.to_string(), port, acceptors_.size());
 }
 
 void ModbusTcpServer::Receive(const exchange::MessagePtr &message) {
-  auto ptr = dynamic_cast<ClientDisconnectMessage *>(message.get());
-  if (ptr) {
+  switch (GetMessageKind(*message)) {
+  case MessageKind::ClientDisconnect: {
     MG_TRACE("ModbusTcpServer({})::Receive: ClientDisconnectMessage", id_);
-    ClientDisconnect(ptr->GetClientId());
+    const auto &clientDisconnect = static_cast<const ClientDisconnectMessage &>(*message);
+    const exchange::ActorId clientId = clientDisconnect.GetClientId();
+    Weak weak = GetWeak();
+    // handled on server strand, not on thread of connection which sent message
+    Deliver(delivery_, strand_, [weak, clientId]() {
+      Ptr self = weak.lock();
+      if (!self) {
+        MG_WARN("ModbusTcpServer::receive: actor was deleted");
+        return;
+      }
+      self->ClientDisconnect(clientId);
+    });
     return;
   }
+  default:
+    break;
+  }
   MG_WARN("ModbusTcpServer({})::Receive: unsupported message", id_);
 }
 
@@ -41,18 +109,62 @@ exchange::ActorId ModbusTcpServer::GetId() {
   return id_;
 }
 
+void ModbusTcpServer::SetDelivery(Delivery delivery) {
+  delivery_ = delivery;
+}
+
+void ModbusTcpServer::SetMemoryBudget(const MemoryBudgetPtr &memoryBudget, size_t connectionLimit) {
+  memoryBudget_ = memoryBudget;
+  connectionMemoryLimit_ = connectionLimit;
+}
+
+void ModbusTcpServer::SetMaxInflight(size_t maxInflight) {
+  maxInflight_ = profile::Clamp(maxInflight, profile::maxInflight);
+}
+
+void ModbusTcpServer::SetInflightTimeout(std::chrono::milliseconds timeout) {
+  inflightTimeout_ = timeout;
+}
+
+void ModbusTcpServer::SetConnectionLimits(const ConnectionLimits &connectionLimits) {
+  connectionLimits_ = connectionLimits;
+  connectionLimits_.maxConnections = profile::Clamp(connectionLimits.maxConnections, profile::maxConnections);
+}
+
+ConnectionStats ModbusTcpServer::GetConnectionStats() const {
+  return {accepted_.load(std::memory_order_relaxed), rejected_.load(std::memory_order_relaxed),
+          reaped_.load(std::memory_order_relaxed), evicted_.load(std::memory_order_relaxed)};
+}
+
 void ModbusTcpServer::Start() {
   assert(id_ != exchange::defaultId);
   MG_DEBUG("ModbusTcpServer({})::Start", id_);
-  AcceptTask();
+  for (size_t shard = 0; shard < acceptors_.size(); ++shard) {
+    AcceptTask(shard);
+  }
+  if (connectionLimits_.idleTimeout.count() > 0) {
+    sweeping_ = true;
+    StartSweepTask();
+  }
 }
 
 void ModbusTcpServer::Stop() {
   MG_DEBUG("ModbusTcpServer({})::Stop", id_);
-  error_code ec;
-  ec = acceptor_.cancel(ec);
-  if (ec) {
-    MG_WARN("ModbusTcpServer({})::Stop acceptor cancel error: {}", id_, ec.message());
+  sweeping_ = false;
+  Weak weak = GetWeak();
+  dispatch(strand_, [weak]() {
+    Ptr self = weak.lock();
+    if (!self) {
+      return;
+    }
+    self->sweepTimer_.cancel();
+  });
+  for (auto &acceptor : acceptors_) {
+    error_code ec;
+    ec = acceptor.cancel(ec);
+    if (ec) {
+      MG_WARN("ModbusTcpServer({})::Stop acceptor cancel error: {}", id_, ec.message());
+    }
   }
   {
     std::scoped_lock<std::mutex> lock(mutex_);
@@ -65,25 +177,31 @@ void ModbusTcpServer::Stop() {
       }
     }
     clientDb_.clear();
+    addressCount_.clear();
   }
 }
 
 ModbusTcpServer::~ModbusTcpServer() {
   MG_DEBUG("ModbusTcpServer({})::Dtor", id_);
   Stop();
-  error_code ec;
-  ec = acceptor_.close(ec);
-  if (ec) {
-    MG_WARN("ModbusTcpServer({})::Dtor acceptor close error: {}", id_, ec.message());
+  for (auto &acceptor : acceptors_) {
+    error_code ec;
+    ec = acceptor.close(ec);
+    if (ec) {
+      MG_WARN("ModbusTcpServer({})::Dtor acceptor close error: {}", id_, ec.message());
+    }
   }
 }
 
-void ModbusTcpServer::AcceptTask() {
-  MG_TRACE("ModbusTcpServer({})::AcceptTask", id_);
-  auto rawSocket = new TcpSocketPtr::element_type(acceptor_.get_executor());
-  TcpSocketPtr socket = std::unique_ptr<TcpSocketPtr::element_type>(rawSocket);
+void ModbusTcpServer::AcceptTask(size_t shard) {
+  MG_TRACE("ModbusTcpServer({})::AcceptTask({})", id_, shard);
+  auto &acceptor = acceptors_[shard];
+  // every connection has own strand on context of accepted shard,
+  // connection handlers are not executed concurrently
+  auto rawSocket = new StrandTcpSocket(make_strand(*contexts_[shard]));
+  StrandTcpSocketPtr socket = std::unique_ptr<StrandTcpSocket>(rawSocket);
   Weak weak = GetWeak();
-  acceptor_.async_accept(*rawSocket, [weak, socket = std::move(socket)](error_code ec) mutable {
+  acceptor.async_accept(*rawSocket, [weak, shard, socket = std::move(socket)](error_code ec) mutable {
     Ptr self = weak.lock();
     if (!self) {
       MG_WARN("ModbusTcpServer::accept: actor was deleted");
@@ -91,7 +209,7 @@ void ModbusTcpServer::AcceptTask() {
     }
     auto exchange = self->exchange_.lock();
     if (!exchange) {
-      MG_WARN("ModbusTcpServer({})::accept: exchange was deleted");
+      MG_WARN("ModbusTcpServer({})::accept: exchange was deleted", self->id_);
       return;
     }
 
@@ -101,25 +219,128 @@ void ModbusTcpServer::AcceptTask() {
         return;
       }
       MG_ERROR("ModbusTcpServer({})::accept: error: {}", self->id_, ec.message());
-      self->AcceptTask();
+      self->AcceptTask(shard);
       return;
     }
-    MG_INFO("ModbusTcpServer({})::accept: connect from {}:{}", self->id_,
-            socket->remote_endpoint().address().to_string(),
-            socket->remote_endpoint().port())
-    auto tcpClient = ModbusTcpConnection::Create(exchange, self->id_, std::move(socket),
-                                                 self->router_);
-    exchange::ActorId clientId = 0;
+    // client may reset connection before it is handled
+    const TcpEndpoint endpoint = socket->remote_endpoint(ec);
+    if (ec) {
+      MG_WARN("ModbusTcpServer({})::accept({}): remote endpoint error: {}", self->id_, shard, ec.message());
+      self->AcceptTask(shard);
+      return;
+    }
+    MG_INFO("ModbusTcpServer({})::accept({}): connect from {}:{}", self->id_, shard,
+            endpoint.address().to_string(), endpoint.port())
+    TcpClientPtr tcpClient;
     {
       std::scoped_lock<std::mutex> lock(self->mutex_);
-      clientId = exchange->Add(tcpClient);
+      if (!self->AdmitUnsafe(endpoint.address(), exchange)) {
+        // socket is closed on release
+        ++self->rejected_;
+        self->AcceptTask(shard);
+        return;
+      }
+      SetOptions(*socket, self->socketOptions_);
+      tcpClient = ModbusTcpConnection::Create(exchange, self->id_, std::move(socket), endpoint, self->router_);
+      tcpClient->SetDelivery(self->delivery_);
+      tcpClient->SetMaxInflight(self->maxInflight_);
+      tcpClient->SetInflightTimeout(self->inflightTimeout_);
+      tcpClient->SetQuickAck(self->socketOptions_.quickAck.value_or(false));
+      if (self->memoryBudget_) {
+        tcpClient->SetMemoryBudget(std::make_shared<MemoryBudget>(self->connectionMemoryLimit_, self->memoryBudget_));
+      }
+      const exchange::ActorId clientId = exchange->Add(tcpClient);
       self->clientDb_[clientId] = tcpClient;
+      ++self->addressCount_[endpoint.address()];
     }
+    ++self->accepted_;
     tcpClient->Start();
-    self->AcceptTask();
+    self->AcceptTask(shard);
+  });
+}
+
+bool ModbusTcpServer::AdmitUnsafe(const asio::ip::address &address, const exchange::ExchangePtr &exchange) {
+  if (connectionLimits_.maxConnectionsPerIp != std::numeric_limits<size_t>::max()) {
+    const auto found = addressCount_.find(address);
+    const size_t fromAddress = addressCount_.end() == found ? 0 : found->second;
+    if (fromAddress >= connectionLimits_.maxConnectionsPerIp) {
+      MG_WARN("ModbusTcpServer({})::accept: connections limit {} of {} reached, close connection", id_,
+              connectionLimits_.maxConnectionsPerIp, address.to_string());
+      return false;
+    }
+  }
+
+  if (clientDb_.size() < connectionLimits_.maxConnections) {
+    return true;
+  }
+  if (!connectionLimits_.evictIdle || clientDb_.empty()) {
+    MG_WARN("ModbusTcpServer({})::accept: connections limit {} reached, close connection", id_,
+            connectionLimits_.maxConnections);
+    return false;
+  }
+  const auto leastActive = std::min_element(clientDb_.begin(), clientDb_.end(), [](const auto &lhs, const auto &rhs) {
+    return lhs.second->GetLastActivity() < rhs.second->GetLastActivity();
+  });
+  MG_WARN("ModbusTcpServer({})::accept: connections limit {} reached, evict least recently active client {}", id_,
+          connectionLimits_.maxConnections, leastActive->first);
+  CloseClientUnsafe(leastActive, exchange);
+  ++evicted_;
+  return true;
+}
+
+void ModbusTcpServer::CloseClientUnsafe(ClientDb::iterator it, const exchange::ExchangePtr &exchange) {
+  it->second->Stop();
+  exchange->Delete(it->first);
+  EraseClientUnsafe(it);
+}
+
+void ModbusTcpServer::EraseClientUnsafe(ClientDb::iterator it) {
+  const auto count = addressCount_.find(it->second->GetRemoteAddress());
+  if (addressCount_.end() != count && 0 == --count->second) {
+    addressCount_.erase(count);
+  }
+  clientDb_.erase(it);
+}
+
+void ModbusTcpServer::StartSweepTask() {
+  // idle connection is reaped in [timeout, 1.25 * timeout]
+  sweepTimer_.expires_after(std::max(connectionLimits_.idleTimeout / 4, std::chrono::milliseconds(1)));
+  Weak weak = GetWeak();
+  sweepTimer_.async_wait([weak](error_code ec) {
+    Ptr self = weak.lock();
+    if (!self) {
+      MG_WARN("ModbusTcpServer::sweep: actor was deleted");
+      return;
+    }
+    if (ec || !self->sweeping_) {
+      MG_DEBUG("ModbusTcpServer({})::sweep: stopped", self->id_);
+      return;
+    }
+    self->Sweep();
+    self->StartSweepTask();
   });
 }
 
+void ModbusTcpServer::Sweep() {
+  auto exchange = exchange_.lock();
+  if (!exchange) {
+    MG_WARN("ModbusTcpServer({})::sweep: exchange was deleted", id_);
+    return;
+  }
+  const auto deadline = std::chrono::steady_clock::now() - connectionLimits_.idleTimeout;
+  std::scoped_lock<std::mutex> lock(mutex_);
+  for (auto it = clientDb_.begin(); it != clientDb_.end();) {
+    if (it->second->GetLastActivity() >= deadline) {
+      ++it;
+      continue;
+    }
+    MG_INFO("ModbusTcpServer({})::sweep: client {} is idle longer than {}ms, close connection", id_, it->first,
+            connectionLimits_.idleTimeout.count());
+    CloseClientUnsafe(it++, exchange);
+    ++reaped_;
+  }
+}
+
 void ModbusTcpServer::ClientDisconnect(exchange::ActorId clientId) {
   std::scoped_lock<std::mutex> lock(mutex_);
   MG_INFO("ModbusTcpServer({})::ClientDisconnect: remove client {}", id_, clientId);
@@ -127,7 +348,10 @@ void ModbusTcpServer::ClientDisconnect(exchange::ActorId clientId) {
   if (exchange) {
     exchange->Delete(clientId);
   }
-  clientDb_.erase(clientId);
+  const auto it = clientDb_.find(clientId);
+  if (clientDb_.end() != it) {
+    EraseClientUnsafe(it);
+  }
 }
 
 }// namespace modbus_gateway
@@ -0,0 +1,89 @@
+#include <transport/request_queue.h>
+
+#include <common/logger.h>
+#include <transport/modbus_exception.h>
+
+#include <cassert>
+
+namespace modbus_gateway {
+
+RequestQueue::RequestQueue(const exchange::ExchangeWeak &exchange, const TimerWheelPtr &timerWheel,
+                           std::chrono::milliseconds timeout, size_t capacity, DropPolicy dropPolicy)
+    : exchange_(exchange),
+      timerWheel_(timerWheel), timeout_(timeout), queue_(capacity), dropPolicy_(dropPolicy) {
+  assert(timerWheel_);
+}
+
+ModbusMessagePtr RequestQueue::Push(const ModbusMessagePtr &message) {
+  ModbusMessagePtr dropped;
+  if (queue_.Full()) {
+    RemoveExpired();
+  }
+  if (queue_.Full()) {
+    switch (dropPolicy_) {
+      case DropPolicy::RejectNewest:
+        return message;
+      case DropPolicy::DropOldest:
+        // every request has same timeout, oldest one reaches deadline first
+        dropped = Take(0);
+        break;
+    }
+  }
+
+  // deadline timer owns queued message and answers it on timeout, queue keeps weak reference
+  const auto deadline = timerWheel_->Arm(timeout_, [exchange = exchange_, message]() {
+    const auto &messageInfo = message->GetModbusMessageInfo();
+    MG_INFO("RequestQueue::expire: queued message reached timeout, message id {}, source id {}",
+            messageInfo.GetTransactionId(), messageInfo.GetSourceId());
+    RejectRequest(exchange, message, ModbusExceptionCode::GatewayTargetFailed);
+  });
+  queue_.Push({message, deadline});
+  return dropped;
+}
+
+bool RequestQueue::Pop(ModbusMessagePtr &message) {
+  while (!queue_.Empty()) {
+    message = Take(0);
+    if (message) {
+      return true;
+    }
+  }
+  message.reset();
+  return false;
+}
+
+size_t RequestQueue::Size() const {
+  return queue_.Size();
+}
+
+bool RequestQueue::Empty() const {
+  return queue_.Empty();
+}
+
+size_t RequestQueue::Capacity() const {
+  return queue_.Capacity();
+}
+
+ModbusMessagePtr RequestQueue::Take(size_t pos) {
+  QueuedMessage queued = queue_.At(pos);
+  queue_.Erase(pos);
+  ModbusMessagePtr message = queued.modbusMessage.lock();
+  // message was already dropped by deadline timer or deadline is being reached now
+  if (message && timerWheel_->Cancel(queued.deadline)) {
+    return message;
+  }
+  return nullptr;
+}
+
+void RequestQueue::RemoveExpired() {
+  size_t pos = 0;
+  while (pos < queue_.Size()) {
+    if (queue_.At(pos).modbusMessage.expired()) {
+      queue_.Erase(pos);
+      continue;
+    }
+    ++pos;
+  }
+}
+
+}// namespace modbus_gateway
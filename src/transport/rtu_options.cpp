@@ -16,7 +16,7 @@ void SetOption(F &flags, const std::optional<bool> &option, R flag) {
   }
 }
 
-void SetOptions(asio::serial_port &serialPort, const RtuOptions &options) {
+void SetOptions(StrandSerialPort &serialPort, const RtuOptions &options) {
   serialPort.set_option(options.baudRate);
   serialPort.set_option(options.characterSize);
   serialPort.set_option(options.parity);
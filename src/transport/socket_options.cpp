@@ -0,0 +1,132 @@
+#include <transport/socket_options.h>
+
+#include <common/logger.h>
+
+namespace modbus_gateway {
+
+namespace {
+
+template<typename Socket, typename Option, typename Value>
+void SetOption(Socket &socket, const Option &option, const char *name, Value value) {
+  asio::error_code ec;
+  ec = socket.set_option(option, ec);
+  if (ec) {
+    MG_WARN("SetOptions: set {} {} error: {}", name, value, ec.message());
+  }
+}
+
+template<typename Socket>
+void SetSocketOptions(Socket &socket, const SocketOptions &options) {
+  if (options.busyPoll.has_value()) {
+#ifdef SO_BUSY_POLL
+    SetOption(socket, BusyPoll(static_cast<int>(options.busyPoll.value())), "busy poll us", options.busyPoll.value());
+#else
+    MG_WARN("SetOptions: busy poll unsupported");
+#endif
+  }
+
+  if (options.noDelay.has_value()) {
+    SetOption(socket, asio::ip::tcp::no_delay(options.noDelay.value()), "no delay", options.noDelay.value());
+  }
+
+  if (options.receiveBuffer.has_value()) {
+    SetOption(socket, asio::socket_base::receive_buffer_size(static_cast<int>(options.receiveBuffer.value())),
+              "receive buffer", options.receiveBuffer.value());
+  }
+
+  if (options.sendBuffer.has_value()) {
+    SetOption(socket, asio::socket_base::send_buffer_size(static_cast<int>(options.sendBuffer.value())),
+              "send buffer", options.sendBuffer.value());
+  }
+
+  if (options.keepAlive.has_value()) {
+    SetOption(socket, asio::socket_base::keep_alive(options.keepAlive.value()), "keep alive", options.keepAlive.value());
+  }
+
+#ifdef TCP_KEEPIDLE
+  if (options.keepAliveIdle.has_value()) {
+    SetOption(socket, KeepAliveIdle(static_cast<int>(options.keepAliveIdle.value())), "keep alive idle s",
+              options.keepAliveIdle.value());
+  }
+  if (options.keepAliveInterval.has_value()) {
+    SetOption(socket, KeepAliveInterval(static_cast<int>(options.keepAliveInterval.value())), "keep alive interval s",
+              options.keepAliveInterval.value());
+  }
+  if (options.keepAliveCount.has_value()) {
+    SetOption(socket, KeepAliveCount(static_cast<int>(options.keepAliveCount.value())), "keep alive count",
+              options.keepAliveCount.value());
+  }
+#else
+  if (options.keepAliveIdle.has_value() || options.keepAliveInterval.has_value() || options.keepAliveCount.has_value()) {
+    MG_WARN("SetOptions: keep alive tuning unsupported");
+  }
+#endif
+
+  if (options.userTimeout.has_value()) {
+#ifdef TCP_USER_TIMEOUT
+    SetOption(socket, UserTimeout(static_cast<int>(options.userTimeout.value())), "user timeout ms",
+              options.userTimeout.value());
+#else
+    MG_WARN("SetOptions: user timeout unsupported");
+#endif
+  }
+
+  if (options.priority.has_value()) {
+#ifdef SO_PRIORITY
+    SetOption(socket, Priority(static_cast<int>(options.priority.value())), "priority", options.priority.value());
+#else
+    MG_WARN("SetOptions: priority unsupported");
+#endif
+  }
+
+  if (options.dscp.has_value()) {
+    // dscp is upper six bits of tos byte, ecn bits are left to kernel
+    const int tos = options.dscp.value() << 2;
+    asio::error_code ec;
+    const auto endpoint = socket.local_endpoint(ec);
+    if (ec) {
+      MG_WARN("SetOptions: set dscp {} error: {}", options.dscp.value(), ec.message());
+    } else if (endpoint.address().is_v6()) {
+      SetOption(socket, TrafficClass(tos), "dscp", options.dscp.value());
+    } else {
+      SetOption(socket, TypeOfService(tos), "dscp", options.dscp.value());
+    }
+  }
+
+  if (options.quickAck.has_value()) {
+#ifdef TCP_QUICKACK
+    SetOption(socket, QuickAck(options.quickAck.value()), "quick ack", options.quickAck.value());
+#else
+    MG_WARN("SetOptions: quick ack unsupported");
+#endif
+  }
+}
+
+template<typename Socket>
+void SetQuickAck(Socket &socket) {
+#ifdef TCP_QUICKACK
+  SetOption(socket, QuickAck(true), "quick ack", true);
+#else
+  (void) socket;
+#endif
+}
+
+}// namespace
+
+void SetOptions(asio::ip::tcp::socket &socket, const SocketOptions &options) {
+  SetSocketOptions(socket, options);
+}
+
+void SetOptions(StrandTcpSocket &socket, const SocketOptions &options) {
+  SetSocketOptions(socket, options);
+}
+
+void RearmQuickAck(asio::ip::tcp::socket &socket) {
+  SetQuickAck(socket);
+}
+
+void RearmQuickAck(StrandTcpSocket &socket) {
+  SetQuickAck(socket);
+}
+
+}// namespace modbus_gateway
@@ -0,0 +1,64 @@
+#include <transport/write_queue.h>
+
+#include <algorithm>
+#include <cassert>
+
+namespace modbus_gateway {
+
+WriteQueue::WriteQueue(size_t maxBatch, size_t capacity)
+    : maxBatch_(maxBatch), capacity_(capacity), pending_(), batch_(), gather_(), writing_(false) {
+  assert(maxBatch_ > 0);
+  assert(capacity_ > 0);
+  pending_.reserve(capacity_);
+}
+
+bool WriteQueue::Push(const ModbusBufferPtr &modbusBuffer) {
+  pending_.push_back(modbusBuffer);
+  if (writing_) {
+    return false;
+  }
+  writing_ = true;
+  return true;
+}
+
+WriteQueue::Buffers WriteQueue::StartBatch() {
+  assert(writing_);
+  assert(batch_.empty());
+  const size_t count = std::min(maxBatch_, pending_.size());
+  // vectors keep capacity, steady state write does not allocate
+  batch_.insert(batch_.end(), pending_.begin(), pending_.begin() + static_cast<std::ptrdiff_t>(count));
+  pending_.erase(pending_.begin(), pending_.begin() + static_cast<std::ptrdiff_t>(count));
+  gather_.clear();
+  for (const auto &modbusBuffer : batch_) {
+    gather_.push_back(asio::buffer(modbusBuffer->begin().operator->(), modbusBuffer->GetAduSize()));
+  }
+  return Buffers(gather_);
+}
+
+bool WriteQueue::CompleteBatch() {
+  batch_.clear();
+  gather_.clear();
+  writing_ = !pending_.empty();
+  return writing_;
+}
+
+void WriteQueue::Reset() {
+  pending_.clear();
+  batch_.clear();
+  gather_.clear();
+  writing_ = false;
+}
+
+bool WriteQueue::Full() const {
+  return pending_.size() >= capacity_;
+}
+
+size_t WriteQueue::Size() const {
+  return pending_.size();
+}
+
+size_t WriteQueue::BatchSize() const {
+  return batch_.size();
+}
+
+}// namespace modbus_gateway
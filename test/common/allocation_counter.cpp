@@ -0,0 +1,115 @@
+#include <common/allocation_counter.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<size_t> allocationCount{0};
+thread_local bool countThread = false;
+
+void Count() {
+  if (countThread) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void *Allocate(size_t size) {
+  Count();
+  void *ptr = std::malloc(size ? size : 1);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void *AllocateAligned(size_t size, std::align_val_t align) {
+  Count();
+  const auto alignment = static_cast<size_t>(align);
+  // aligned_alloc requires size multiple of alignment
+  const size_t alignedSize = (size + alignment - 1) / alignment * alignment;
+  void *ptr = std::aligned_alloc(alignment, alignedSize ? alignedSize : alignment);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+}// namespace
+
+namespace test {
+
+size_t GetAllocationCount() {
+  return allocationCount.load(std::memory_order_relaxed);
+}
+
+void CountThisThread() {
+  countThread = true;
+}
+
+}// namespace test
+
+void *operator new(size_t size) {
+  return Allocate(size);
+}
+
+void *operator new[](size_t size) {
+  return Allocate(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  try {
+    return Allocate(size);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  try {
+    return Allocate(size);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void *operator new(size_t size, std::align_val_t align) {
+  return AllocateAligned(size, align);
+}
+
+void *operator new[](size_t size, std::align_val_t align) {
+  return AllocateAligned(size, align);
+}
+
+void operator delete(void *ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+
+namespace test {
+
+// Number of global operator new calls made on counted threads. Counting operators are defined in
+// allocation_counter.cpp, it is linked only to allocation test target
+size_t GetAllocationCount();
+
+// Count allocations of calling thread, other threads (test body, fixtures) are not counted
+void CountThisThread();
+
+}// namespace test
@@ -22,4 +22,10 @@ exchange::ExchangePtr MakeExchange() {
                                               std::make_shared<exchange::IdGeneratorReuse>());
 }
 
+asio::ip::port_type FreePort(const asio::ip::address &addr) {
+  asio::io_context context;
+  asio::ip::tcp::acceptor acceptor(context, asio::ip::tcp::endpoint(addr, 0));
+  return acceptor.local_endpoint().port();
+}
+
 }// namespace test
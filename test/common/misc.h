@@ -1,5 +1,7 @@
 #pragma once
 
+#include <common/types_asio.h>
+
 #include <modbus/modbus_buffer.h>
 
 #include <exchange/iexchange.h>
@@ -29,4 +31,7 @@ modbus::ModbusBuffer MakeModbusBuffer(const modbus::AduBuffer &frame, modbus::Fr
 
 exchange::ExchangePtr MakeExchange();
 
+// Port which is free on address now, lets parallel test runs listen without collision
+asio::ip::port_type FreePort(const asio::ip::address &addr);
+
 }// namespace test
@@ -10,8 +10,7 @@ ModbusMessageActor::ModbusMessageActor(const exchange::ExchangePtr &exchange)
 
 void ModbusMessageActor::Receive(const exchange::MessagePtr &message) {
   MG_TRACE("ModbusMessageActor({})::Receive message", id_);
-  const modbus_gateway::ModbusMessagePtr &modbusMessage = std::dynamic_pointer_cast<modbus_gateway::ModbusMessagePtr::element_type>(
-      message);
+  const modbus_gateway::ModbusMessagePtr modbusMessage = modbus_gateway::MessageCast<modbus_gateway::ModbusMessage>(message);
 
   if (modbusMessage) {
     const exchange::ActorId sourceId = modbusMessage->GetModbusMessageInfo().GetSourceId();
@@ -11,13 +11,13 @@ ModbusMessageSender::ModbusMessageSender(const exchange::ExchangePtr &exchange)
 
 void ModbusMessageSender::Receive(const exchange::MessagePtr &message) {
   MG_TRACE("ModbusMessageSender({})::Receive message", id_);
-  const modbus_gateway::ModbusMessagePtr &modbusMessage = std::dynamic_pointer_cast<modbus_gateway::ModbusMessagePtr::element_type>(
-      message);
+  const modbus_gateway::ModbusMessagePtr modbusMessage = modbus_gateway::MessageCast<modbus_gateway::ModbusMessage>(message);
 
   if (modbusMessage) {
     const exchange::ActorId sourceId = modbusMessage->GetModbusMessageInfo().GetSourceId();
     MG_DEBUG("ModbusMessageSender({})::Receive modbus message from {}", id_, sourceId);
     receiveMessage = modbusMessage;
+    ++receiveCount;
     return;
   }
   MG_CRIT("ModbusMessageSender({})::Receive unknown message type", id_);
@@ -38,7 +38,7 @@ exchange::ActorId ModbusMessageSender::GetId() {
 void ModbusMessageSender::SendTo(const modbus_gateway::ModbusBufferPtr &modbusBuffer, exchange::ActorId target) {
   const auto transactionId = ++transactionIdGenerator_;
   const auto modbusMessageInfo = modbus_gateway::ModbusMessageInfo{id_, transactionId};
-  auto modbusMessage = modbus_gateway::ModbusMessage::Create(modbusMessageInfo, modbusBuffer);
+  auto modbusMessage = modbus_gateway::MakeModbusMessage(modbusMessageInfo, modbusBuffer);
   MG_INFO("ModbusMessageSender({})::SendTo: transactionId {}, targetId {}", id_, transactionId, target);
   auto exchange = exchange_.lock();
   if (exchange) {
@@ -5,6 +5,8 @@
 
 #include <message/modbus_message.h>
 
+#include <atomic>
+
 namespace test {
 
 class ModbusMessageSender : public exchange::ActorHelper<ModbusMessageSender> {
@@ -24,6 +26,7 @@ public:
   void SendTo(const modbus_gateway::ModbusBufferPtr &modbusBuffer, exchange::ActorId target);
 
   modbus_gateway::ModbusMessagePtr receiveMessage = nullptr;
+  std::atomic<size_t> receiveCount{0};
 
 private:
   exchange::ActorId id_;
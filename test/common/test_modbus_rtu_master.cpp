@@ -16,7 +16,8 @@ void TestModbusRtuMaster::Cancel() {
   }
 }
 
-void TestModbusRtuMaster::Process(const modbus_gateway::ModbusBufferPtr &sendModbusBuffer, const modbus_gateway::ModbusBufferPtr &receiveModbusBuffer) {
+void TestModbusRtuMaster::Process(const modbus_gateway::ModbusBufferPtr &sendModbusBuffer, const modbus_gateway::ModbusBufferPtr &receiveModbusBuffer,
+                                  const Callback &callback) {
   serialPort_.async_write_some(asio::buffer(sendModbusBuffer->begin().base(), sendModbusBuffer->GetAduSize()),
                                [=](asio::error_code ec, size_t size) {
                                  if (ec) {
@@ -32,6 +33,9 @@ void TestModbusRtuMaster::Process(const modbus_gateway::ModbusBufferPtr &sendMod
                                                                }
                                                                MG_DEBUG("TestModbusRtuMaster::read: {} bytes", size);
                                                                receiveModbusBuffer->SetAduSize(size);
+                                                               if (callback) {
+                                                                 callback();
+                                                               }
                                                              });
                                });
 }
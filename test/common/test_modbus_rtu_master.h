@@ -3,16 +3,22 @@
 #include <common/types_asio.h>
 #include <common/types_modbus.h>
 
+#include <functional>
+
 namespace test {
 
 class TestModbusRtuMaster {
 public:
+  using Callback = std::function<void()>;
+
   TestModbusRtuMaster(const modbus_gateway::ContextPtr &context, const std::string &device);
 
   void Cancel();
 
+  // Callback is called after response is received
   void Process(const modbus_gateway::ModbusBufferPtr &sendModbusBuffer,
-               const modbus_gateway::ModbusBufferPtr &receiveModbusBuffer);
+               const modbus_gateway::ModbusBufferPtr &receiveModbusBuffer,
+               const Callback &callback = nullptr);
 
 private:
   asio::serial_port serialPort_;
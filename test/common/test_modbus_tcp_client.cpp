@@ -22,7 +22,8 @@ asio::error_code TestModbusTcpClient::Disconnect() {
 }
 
 void TestModbusTcpClient::Process(const modbus_gateway::ModbusBufferPtr &sendModbusBuffer,
-                                  const modbus_gateway::ModbusBufferPtr &receiveModbusBuffer) {
+                                  const modbus_gateway::ModbusBufferPtr &receiveModbusBuffer,
+                                  const Callback &callback) {
   socket_->async_send(asio::buffer(sendModbusBuffer->begin().base(), sendModbusBuffer->GetAduSize()),
                       [=](asio::error_code ec, size_t size) {
                         if (ec) {
@@ -33,13 +34,16 @@ void TestModbusTcpClient::Process(const modbus_gateway::ModbusBufferPtr &sendMod
                         socket_->async_receive(
                             asio::buffer(receiveModbusBuffer->begin().base(),
                                          receiveModbusBuffer->GetAduSize()),
-                            [receiveModbusBuffer](asio::error_code ec, size_t size) {
+                            [receiveModbusBuffer, callback](asio::error_code ec, size_t size) {
                               if (ec) {
                                 MG_INFO("TestModbusTcpClient::receive error: {}", ec.message())
                                 return;
                               }
                               MG_INFO("TestModbusTcpClient::receive {} bytes", size)
                               receiveModbusBuffer->SetAduSize(size);
+                              if (callback) {
+                                callback();
+                              }
                             });
                       });
 }
@@ -3,10 +3,14 @@
 #include <common/types_asio.h>
 #include <common/types_modbus.h>
 
+#include <functional>
+
 namespace test {
 
 class TestModbusTcpClient {
 public:
+  using Callback = std::function<void()>;
+
   TestModbusTcpClient(const modbus_gateway::ContextPtr &context, const asio::ip::address &addr,
                       asio::ip::port_type port);
 
@@ -14,8 +18,10 @@ public:
 
   asio::error_code Disconnect();
 
+  // Callback is called after response is received
   void Process(const modbus_gateway::ModbusBufferPtr &sendModbusBuffer,
-               const modbus_gateway::ModbusBufferPtr &receiveModbusBuffer);
+               const modbus_gateway::ModbusBufferPtr &receiveModbusBuffer,
+               const Callback &callback = nullptr);
 
 private:
   modbus_gateway::TcpSocketPtr socket_;
@@ -0,0 +1,240 @@
+#include <gtest/gtest.h>
+
+#include <common/allocation_counter.h>
+#include <common/context_runner.h>
+#include <common/misc.h>
+#include <common/modbus_message_actor.h>
+#include <common/modbus_message_sender.h>
+#include <common/rtu_creator.h>
+#include <common/single_router.h>
+#include <common/test_modbus_rtu_master.h>
+#include <common/test_modbus_rtu_slave.h>
+#include <common/test_modbus_tcp_client.h>
+#include <common/test_modbus_tcp_server.h>
+
+#include <transport/modbus_rtu_master.h>
+#include <transport/modbus_rtu_slave.h>
+#include <transport/modbus_tcp_client.h>
+#include <transport/modbus_tcp_server.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <optional>
+#include <string>
+#include <thread>
+
+// Steady state allocations of every transport. Round trips go one after another, allocations are counted
+// after warm up, when pools and handler memory are filled. Only thread of transport context is counted,
+// test fixtures run on own context, so budget is allocation count of transport hot path.
+// Two allocations per transaction are left: storage of new ModbusBuffer, it is allocated inside modbus library,
+// and strand handler which is queued while strand runs, single block cache of asio 1.18 does not keep it.
+// Lower budget when one of them is removed
+
+namespace {
+
+constexpr size_t warmUp = 200;
+constexpr size_t transactions = 2000;
+constexpr auto waitTransaction = std::chrono::seconds(2);
+
+const modbus::AduBuffer tcpFrame = {0x0, 0x1, 0x0, 0x0, 0x0, 0x3, 0x1, 0x3, 0x4};
+const modbus::AduBuffer rtuFrame = {0x1, 0x6, 0xDF, 0x62, 0x38};
+
+bool WaitCount(const std::atomic<size_t> &counter, size_t expected) {
+  const auto deadline = std::chrono::steady_clock::now() + waitTransaction;
+  while (counter.load() < expected) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::yield();
+  }
+  return true;
+}
+
+// Return allocations per round trip, nullopt if some round trip is not completed
+template<typename RoundTrip>
+std::optional<double> AllocationsPerTransaction(RoundTrip roundTrip) {
+  for (size_t i = 0; i < warmUp; ++i) {
+    if (!roundTrip()) {
+      return std::nullopt;
+    }
+  }
+  const size_t begin = test::GetAllocationCount();
+  for (size_t i = 0; i < transactions; ++i) {
+    if (!roundTrip()) {
+      return std::nullopt;
+    }
+  }
+  const size_t end = test::GetAllocationCount();
+  return static_cast<double>(end - begin) / static_cast<double>(transactions);
+}
+
+}// namespace
+
+struct AllocationTest : testing::Test {
+protected:
+  void SetUp() override {
+    contextRunner.Run();
+    fixtureRunner.Run();
+    exchange = test::MakeExchange();
+
+    std::promise<void> counted;
+    asio::post(*contextRunner.GetContext(), [&counted]() {
+      test::CountThisThread();
+      counted.set_value();
+    });
+    counted.get_future().wait();
+  }
+
+  void TearDown() override {
+    fixtureRunner.Stop();
+    contextRunner.Stop();
+  }
+
+  void Check(const std::optional<double> &allocations, double budget) {
+    ASSERT_TRUE(allocations.has_value()) << "round trip is not completed";
+    RecordProperty("allocations_per_transaction", std::to_string(allocations.value()));
+    EXPECT_LE(allocations.value(), budget);
+  }
+
+  const asio::ip::address_v4 addr = asio::ip::address_v4::loopback();
+  const asio::ip::port_type port = test::FreePort(asio::ip::address(addr));
+  static constexpr auto messageTimeout = std::chrono::milliseconds(1000);
+
+  // transport under test, allocations of its thread are counted
+  test::ContextRunner contextRunner = test::ContextRunner{1};
+  // peer of transport
+  test::ContextRunner fixtureRunner = test::ContextRunner{1};
+  exchange::ExchangePtr exchange = nullptr;
+};
+
+// TestModbusTcpClient -> ModbusTcpServer -> ModbusMessageActor
+TEST_F(AllocationTest, TcpServer) {
+  static constexpr double budget = 2;
+  auto context = contextRunner.GetContext();
+
+  auto echoActor = test::ModbusMessageActor::Create(exchange);
+  const exchange::ActorId echoActorId = exchange->Add(echoActor);
+  modbus_gateway::RouterPtr singleRouter = std::make_shared<test::SingleRouter>(echoActorId);
+  auto tcpServer = modbus_gateway::ModbusTcpServer::Create(exchange, context, asio::ip::address(addr), port,
+                                                           singleRouter, modbus_gateway::SocketOptions{});
+  exchange->Add(tcpServer);
+  tcpServer->Start();
+
+  test::TestModbusTcpClient testClient(fixtureRunner.GetContext(), asio::ip::address(addr), port);
+  ASSERT_FALSE(testClient.Connect());
+
+  auto sendBuffer = std::make_shared<modbus::ModbusBuffer>(test::MakeModbusBuffer(tcpFrame, modbus::FrameType::TCP));
+  auto receiveBuffer = std::make_shared<modbus::ModbusBuffer>(modbus::FrameType::TCP);
+  std::atomic<size_t> received{0};
+  const test::TestModbusTcpClient::Callback callback = [&received]() {
+    ++received;
+  };
+
+  Check(AllocationsPerTransaction([&]() {
+          const size_t expected = received + 1;
+          testClient.Process(sendBuffer, receiveBuffer, callback);
+          return WaitCount(received, expected);
+        }),
+        budget);
+
+  testClient.Disconnect();
+  tcpServer->Stop();
+}
+
+// ModbusMessageSender -> ModbusTcpClient -> TestModbusTcpServer
+TEST_F(AllocationTest, TcpClient) {
+  static constexpr double budget = 2;
+  auto context = contextRunner.GetContext();
+
+  auto sender = test::ModbusMessageSender::Create(exchange);
+  exchange->Add(sender);
+
+  test::TestModbusTcpServer testServer(fixtureRunner.GetContext(), addr, port);
+  testServer.Start();
+
+  auto timerWheel = std::make_shared<modbus_gateway::TimerWheel>(context, std::chrono::milliseconds(1), 64);
+  auto tcpClient = modbus_gateway::ModbusTcpClient::Create(exchange, context, timerWheel, addr, port, messageTimeout,
+                                                           modbus_gateway::SocketOptions{});
+  const exchange::ActorId tcpClientId = exchange->Add(tcpClient);
+
+  auto sendBuffer = std::make_shared<modbus::ModbusBuffer>(test::MakeModbusBuffer(tcpFrame, modbus::FrameType::TCP));
+
+  Check(AllocationsPerTransaction([&]() {
+          const size_t expected = sender->receiveCount + 1;
+          // request comes from thread of transport, as from slave sharing its context in gateway
+          asio::post(*context, [&]() {
+            sender->SendTo(sendBuffer, tcpClientId);
+          });
+          return WaitCount(sender->receiveCount, expected);
+        }),
+        budget);
+
+  testServer.Stop();
+  timerWheel->Stop();
+}
+
+// TestModbusRtuMaster -> ModbusRtuSlave -> ModbusMessageActor
+TEST_F(AllocationTest, RtuSlave) {
+  static constexpr double budget = 2;
+  auto context = contextRunner.GetContext();
+
+  auto echoActor = test::ModbusMessageActor::Create(exchange);
+  const exchange::ActorId echoActorId = exchange->Add(echoActor);
+  modbus_gateway::RouterPtr singleRouter = std::make_shared<test::SingleRouter>(echoActorId);
+  auto rtuSlave = modbus_gateway::ModbusRtuSlave::Create(exchange, context, test::deviceOut,
+                                                         modbus_gateway::RtuOptions{}, singleRouter);
+  exchange->Add(rtuSlave);
+  rtuSlave->Start();
+
+  test::TestModbusRtuMaster testMaster(fixtureRunner.GetContext(), test::deviceIn);
+
+  auto sendBuffer = std::make_shared<modbus::ModbusBuffer>(test::MakeModbusBuffer(rtuFrame, modbus::FrameType::RTU));
+  auto receiveBuffer = std::make_shared<modbus::ModbusBuffer>(modbus::FrameType::RTU);
+  std::atomic<size_t> received{0};
+  const test::TestModbusRtuMaster::Callback callback = [&received]() {
+    ++received;
+  };
+
+  Check(AllocationsPerTransaction([&]() {
+          const size_t expected = received + 1;
+          testMaster.Process(sendBuffer, receiveBuffer, callback);
+          return WaitCount(received, expected);
+        }),
+        budget);
+
+  testMaster.Cancel();
+  rtuSlave->Stop();
+}
+
+// ModbusMessageSender -> ModbusRtuMaster -> TestModbusRtuSlave
+TEST_F(AllocationTest, RtuMaster) {
+  static constexpr double budget = 2;
+  auto context = contextRunner.GetContext();
+
+  auto sender = test::ModbusMessageSender::Create(exchange);
+  exchange->Add(sender);
+
+  auto timerWheel = std::make_shared<modbus_gateway::TimerWheel>(context, std::chrono::milliseconds(1), 64);
+  auto rtuMaster = modbus_gateway::ModbusRtuMaster::Create(exchange, context, timerWheel, test::deviceIn,
+                                                           modbus_gateway::RtuOptions{}, messageTimeout);
+  const exchange::ActorId rtuMasterId = exchange->Add(rtuMaster);
+
+  test::TestModbusRtuSlave testSlave(fixtureRunner.GetContext(), test::deviceOut, modbus::RTU);
+  testSlave.Start();
+
+  auto sendBuffer = std::make_shared<modbus::ModbusBuffer>(test::MakeModbusBuffer(rtuFrame, modbus::FrameType::RTU));
+
+  Check(AllocationsPerTransaction([&]() {
+          const size_t expected = sender->receiveCount + 1;
+          // request comes from thread of transport, as from slave sharing its context in gateway
+          asio::post(*context, [&]() {
+            sender->SendTo(sendBuffer, rtuMasterId);
+          });
+          return WaitCount(sender->receiveCount, expected);
+        }),
+        budget);
+
+  testSlave.Stop();
+  timerWheel->Stop();
+}
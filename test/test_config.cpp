@@ -208,6 +208,257 @@ TEST(ConfigTest, ServiceSectionOptionalTest) {
   EXPECT_NO_THROW(configService = modbus_gateway::ExtractConfigService(tracePath, data));
   EXPECT_EQ(configService.logLevel, modbus_gateway::Logger::LogLevel::Info);
   EXPECT_EQ(configService.threads, 1);
+  EXPECT_EQ(configService.rtuContext, modbus_gateway::RtuContextMode::Shared);
+  EXPECT_FALSE(configService.realtime.has_value());
+  EXPECT_FALSE(configService.busyPoll.has_value());
+  EXPECT_EQ(configService.delivery, modbus_gateway::Delivery::Post);
+  EXPECT_FALSE(configService.memoryBudget.has_value());
+}
+
+TEST(ConfigTest, ServiceSectionInvalidThreadsTest) {
+  std::stringstream is;
+  is << R"(
+{
+  "service": {
+    "threads": 0
+  }
+}
+)";
+  auto data = nlohmann::json::parse(is);
+  modbus_gateway::TracePath tracePath;
+  tracePath.Push("config");
+
+  EXPECT_THROW(modbus_gateway::ExtractConfigService(tracePath, data), modbus_gateway::InvalidValueException);
+}
+
+TEST(ConfigTest, ServiceSectionRtuContextTest) {
+  std::stringstream is;
+  is << R"(
+{
+  "service": {
+    "threads": 2,
+    "rtu_context": "per_device"
+  }
+}
+)";
+  auto data = nlohmann::json::parse(is);
+  modbus_gateway::TracePath tracePath;
+  tracePath.Push("config");
+
+  modbus_gateway::ConfigService configService;
+  EXPECT_NO_THROW(configService = modbus_gateway::ExtractConfigService(tracePath, data));
+  EXPECT_EQ(configService.threads, 2);
+  EXPECT_EQ(configService.rtuContext, modbus_gateway::RtuContextMode::PerDevice);
+}
+
+TEST(ConfigTest, ServiceSectionInvalidRtuContextTest) {
+  std::stringstream is;
+  is << R"(
+{
+  "service": {
+    "rtu_context": "separate"
+  }
+}
+)";
+  auto data = nlohmann::json::parse(is);
+  modbus_gateway::TracePath tracePath;
+  tracePath.Push("config");
+
+  EXPECT_THROW(modbus_gateway::ExtractConfigService(tracePath, data), modbus_gateway::InvalidValueException);
+}
+
+TEST(ConfigTest, ServiceSectionRealtimeTest) {
+  std::stringstream is;
+  is << R"(
+{
+  "service": {
+    "realtime": {
+      "policy": "fifo",
+      "priority": 50,
+      "rtu_priority": 80,
+      "cpu_affinity": [0],
+      "rtu_cpu_affinity": [],
+      "mlockall": true,
+      "prefault_stack": 65536,
+      "prefault_heap": 1048576
+    }
+  }
+}
+)";
+  auto data = nlohmann::json::parse(is);
+  modbus_gateway::TracePath tracePath;
+  tracePath.Push("config");
+
+  modbus_gateway::ConfigService configService;
+  EXPECT_NO_THROW(configService = modbus_gateway::ExtractConfigService(tracePath, data));
+  ASSERT_TRUE(configService.realtime.has_value());
+  EXPECT_EQ(configService.realtime->policy, modbus_gateway::SchedPolicy::Fifo);
+  EXPECT_EQ(configService.realtime->priority, 50);
+  EXPECT_EQ(configService.realtime->rtuPriority, 80);
+  EXPECT_EQ(configService.realtime->cpuAffinity, modbus_gateway::CpuSet{0});
+  EXPECT_TRUE(configService.realtime->rtuCpuAffinity.empty());
+  EXPECT_TRUE(configService.realtime->lockMemory);
+  EXPECT_EQ(configService.realtime->prefaultStack, 65536);
+  EXPECT_EQ(configService.realtime->prefaultHeap, 1048576);
+}
+
+TEST(ConfigTest, ServiceSectionRealtimeDefaultTest) {
+  std::stringstream is;
+  is << R"(
+{
+  "service": {
+    "realtime": {
+      "cpu_affinity": [0]
+    }
+  }
+}
+)";
+  auto data = nlohmann::json::parse(is);
+  modbus_gateway::TracePath tracePath;
+  tracePath.Push("config");
+
+  modbus_gateway::ConfigService configService;
+  EXPECT_NO_THROW(configService = modbus_gateway::ExtractConfigService(tracePath, data));
+  ASSERT_TRUE(configService.realtime.has_value());
+  EXPECT_EQ(configService.realtime->rtuPriority, configService.realtime->priority);
+  EXPECT_EQ(configService.realtime->rtuCpuAffinity, modbus_gateway::CpuSet{0});
+}
+
+TEST(ConfigTest, ServiceSectionInvalidRealtimeTest) {
+  std::stringstream is;
+  is << R"(
+{
+  "service1": {
+    "realtime": {
+      "policy": "deadline"
+    }
+  },
+  "service2": {
+    "realtime": {
+      "priority": 10
+    }
+  },
+  "service3": {
+    "realtime": {
+      "policy": "rr",
+      "priority": 200
+    }
+  },
+  "service4": {
+    "realtime": {
+      "rtu_cpu_affinity": [100000]
+    }
+  }
+}
+)";
+  auto data = nlohmann::json::parse(is);
+  for (const std::string service : {"service1", "service2", "service3", "service4"}) {
+    modbus_gateway::TracePath tracePath;
+    modbus_gateway::TraceDeep td(tracePath, service);
+    const auto &obj = modbus_gateway::FindObject(td, data);
+    EXPECT_THROW(modbus_gateway::ExtractRealtimeOptions(td.GetTracePath(), obj), modbus_gateway::InvalidValueException);
+  }
+}
+
+TEST(ConfigTest, ServiceSectionBusyPollTest) {
+  std::stringstream is;
+  is << R"(
+{
+  "service": {
+    "busy_poll": {
+      "network": true,
+      "socket_us": 50
+    }
+  }
+}
+)";
+  auto data = nlohmann::json::parse(is);
+  modbus_gateway::TracePath tracePath;
+  tracePath.Push("config");
+
+  modbus_gateway::ConfigService configService;
+  EXPECT_NO_THROW(configService = modbus_gateway::ExtractConfigService(tracePath, data));
+  ASSERT_TRUE(configService.busyPoll.has_value());
+  EXPECT_TRUE(configService.busyPoll->network);
+  EXPECT_FALSE(configService.busyPoll->rtu);
+  EXPECT_EQ(configService.busyPoll->socket, 50);
+}
+
+TEST(ConfigTest, ServiceSectionDeliveryTest) {
+  {
+    std::stringstream is;
+    is << R"(
+{
+  "service": {
+    "delivery": "inline"
+  }
+}
+)";
+    auto data = nlohmann::json::parse(is);
+    modbus_gateway::TracePath tracePath;
+    tracePath.Push("config");
+
+    modbus_gateway::ConfigService configService;
+    EXPECT_NO_THROW(configService = modbus_gateway::ExtractConfigService(tracePath, data));
+    EXPECT_EQ(configService.delivery, modbus_gateway::Delivery::Inline);
+  }
+  {
+    std::stringstream is;
+    is << R"(
+{
+  "service": {
+    "delivery": "sync"
+  }
+}
+)";
+    auto data = nlohmann::json::parse(is);
+    modbus_gateway::TracePath tracePath;
+    tracePath.Push("config");
+
+    EXPECT_THROW(modbus_gateway::ExtractConfigService(tracePath, data), modbus_gateway::InvalidValueException);
+  }
+}
+
+TEST(ConfigTest, ServiceSectionMemoryBudgetTest) {
+  {
+    std::stringstream is;
+    is << R"(
+{
+  "service": {
+    "memory_budget": {
+      "connection_bytes": 65536,
+      "global_bytes": 4194304
+    }
+  }
+}
+)";
+    auto data = nlohmann::json::parse(is);
+    modbus_gateway::TracePath tracePath;
+    tracePath.Push("config");
+
+    modbus_gateway::ConfigService configService;
+    EXPECT_NO_THROW(configService = modbus_gateway::ExtractConfigService(tracePath, data));
+    ASSERT_TRUE(configService.memoryBudget.has_value());
+    EXPECT_EQ(configService.memoryBudget->connection, 65536);
+    EXPECT_EQ(configService.memoryBudget->global, 4194304);
+  }
+  {
+    std::stringstream is;
+    is << R"(
+{
+  "service": {
+    "memory_budget": {
+      "connection_bytes": 0
+    }
+  }
+}
+)";
+    auto data = nlohmann::json::parse(is);
+    modbus_gateway::TracePath tracePath;
+    tracePath.Push("config");
+
+    EXPECT_THROW(modbus_gateway::ExtractConfigService(tracePath, data), modbus_gateway::InvalidValueException);
+  }
 }
 
 TEST(ConfigTest, SlaveTcpTest) {
@@ -217,7 +468,26 @@ TEST(ConfigTest, SlaveTcpTest) {
   "slave": {
     "frame_type": "tcp",
     "ip_address": "192.168.1.2",
-    "ip_port": 1234
+    "ip_port": 1234,
+    "shards": 4,
+    "max_inflight": 3,
+    "max_connections": 8,
+    "max_connections_per_ip": 2,
+    "idle_timeout_ms": 60000,
+    "evict_idle": true,
+    "socket": {
+      "no_delay": true,
+      "quick_ack": true,
+      "receive_buffer": 65536,
+      "send_buffer": 32768,
+      "keep_alive": true,
+      "keep_alive_idle_s": 10,
+      "keep_alive_interval_s": 2,
+      "keep_alive_count": 3,
+      "user_timeout_ms": 16000,
+      "priority": 6,
+      "dscp": 46
+    }
   }
 }
 )";
@@ -237,6 +507,26 @@ TEST(ConfigTest, SlaveTcpTest) {
 
   EXPECT_EQ(tcpServerConfig->address, asio::ip::address::from_string("192.168.1.2"));
   EXPECT_EQ(tcpServerConfig->port, 1234);
+  EXPECT_EQ(tcpServerConfig->shards, 4);
+  EXPECT_EQ(tcpServerConfig->maxInflight, 3);
+  EXPECT_EQ(tcpServerConfig->connectionLimits.maxConnections, 8);
+  EXPECT_EQ(tcpServerConfig->connectionLimits.maxConnectionsPerIp, 2);
+  EXPECT_EQ(tcpServerConfig->connectionLimits.idleTimeout.count(), 60000);
+  EXPECT_TRUE(tcpServerConfig->connectionLimits.evictIdle);
+
+  const auto &socketOptions = tcpServerConfig->socketOptions;
+  EXPECT_FALSE(socketOptions.busyPoll.has_value());
+  EXPECT_EQ(socketOptions.noDelay, true);
+  EXPECT_EQ(socketOptions.quickAck, true);
+  EXPECT_EQ(socketOptions.receiveBuffer, 65536);
+  EXPECT_EQ(socketOptions.sendBuffer, 32768);
+  EXPECT_EQ(socketOptions.keepAlive, true);
+  EXPECT_EQ(socketOptions.keepAliveIdle, 10);
+  EXPECT_EQ(socketOptions.keepAliveInterval, 2);
+  EXPECT_EQ(socketOptions.keepAliveCount, 3);
+  EXPECT_EQ(socketOptions.userTimeout, 16000);
+  EXPECT_EQ(socketOptions.priority, 6);
+  EXPECT_EQ(socketOptions.dscp, 46);
 }
 
 TEST(ConfigTest, SlaveTcpOptionalTest) {
@@ -265,6 +555,41 @@ TEST(ConfigTest, SlaveTcpOptionalTest) {
 
   EXPECT_EQ(tcpServerConfig->address, asio::ip::address_v4::any());
   EXPECT_EQ(tcpServerConfig->port, 4321);
+  EXPECT_EQ(tcpServerConfig->shards, 0);
+  EXPECT_EQ(tcpServerConfig->maxInflight, modbus_gateway::profile::maxInflight);
+  EXPECT_EQ(tcpServerConfig->connectionLimits.maxConnections, modbus_gateway::profile::maxConnections);
+  EXPECT_EQ(tcpServerConfig->connectionLimits.idleTimeout.count(), 0);
+  EXPECT_FALSE(tcpServerConfig->connectionLimits.evictIdle);
+  EXPECT_FALSE(tcpServerConfig->socketOptions.noDelay.has_value());
+  EXPECT_FALSE(tcpServerConfig->socketOptions.keepAlive.has_value());
+  EXPECT_FALSE(tcpServerConfig->socketOptions.dscp.has_value());
+}
+
+TEST(ConfigTest, SlaveTcpProfileLimitTest) {
+  // over every limit of embedded profile, default profile takes values as is
+  for (const std::string limit: {R"("max_inflight": 1000)", R"("max_connections": 1000)"}) {
+    std::stringstream is;
+    is << R"(
+{
+  "slave": {
+    "frame_type": "tcp",
+    "ip_port": 4321,
+    )" << limit << R"(
+  }
+}
+)";
+    auto data = nlohmann::json::parse(is);
+    modbus_gateway::TracePath tp;
+    modbus_gateway::TraceDeep td(tp, "slave");
+
+    auto slave = modbus_gateway::FindObject(td, data);
+
+    if (modbus_gateway::profile::embedded) {
+      EXPECT_THROW(modbus_gateway::ExtractSlave(td.GetTracePath(), slave), modbus_gateway::InvalidValueException);
+    } else {
+      EXPECT_NO_THROW(modbus_gateway::ExtractSlave(td.GetTracePath(), slave));
+    }
+  }
 }
 
 TEST(ConfigTest, SlaveRtuTest) {
@@ -398,8 +723,15 @@ TEST(ConfigTest, MasterTcpTest) {
   "master": {
     "frame_type": "tcp",
     "timeout_ms": 1234,
+    "queue_size": 16,
+    "drop_policy": "reject_newest",
     "ip_address": "192.168.3.2",
     "ip_port": 444,
+    "socket": {
+      "no_delay": false,
+      "keep_alive": true,
+      "user_timeout_ms": 3000
+    },
     "unit_id": [
       {
         "type": "range",
@@ -428,6 +760,12 @@ TEST(ConfigTest, MasterTcpTest) {
   EXPECT_EQ(tcpMasterConfig->port, 444);
   EXPECT_EQ(tcpMasterConfig->timeout.count(), 1234);
   EXPECT_EQ(tcpMasterConfig->unitIdSet.size(), 1);
+  EXPECT_EQ(tcpMasterConfig->queueSize, 16);
+  EXPECT_EQ(tcpMasterConfig->dropPolicy, modbus_gateway::DropPolicy::RejectNewest);
+  EXPECT_EQ(tcpMasterConfig->socketOptions.noDelay, false);
+  EXPECT_EQ(tcpMasterConfig->socketOptions.keepAlive, true);
+  EXPECT_EQ(tcpMasterConfig->socketOptions.userTimeout, 3000);
+  EXPECT_FALSE(tcpMasterConfig->socketOptions.quickAck.has_value());
 }
 
 TEST(ConfigTest, MasterTcpOptionalTest) {
@@ -460,6 +798,87 @@ TEST(ConfigTest, MasterTcpOptionalTest) {
   EXPECT_EQ(tcpMasterConfig->port, 555);
   EXPECT_EQ(tcpMasterConfig->timeout.count(), 4444);
   EXPECT_EQ(tcpMasterConfig->unitIdSet.size(), 0);
+  EXPECT_EQ(tcpMasterConfig->queueSize, modbus_gateway::profile::queueDepth);
+  EXPECT_EQ(tcpMasterConfig->dropPolicy, modbus_gateway::DropPolicy::DropOldest);
+  EXPECT_FALSE(tcpMasterConfig->socketOptions.noDelay.has_value());
+}
+
+TEST(ConfigTest, MasterSocketInvalidTest) {
+  for (const std::string socket: {R"("socket": 1)", R"("socket": {"no_delay": 1})",
+                                  R"("socket": {"keep_alive_count": 0})", R"("socket": {"dscp": 64})"}) {
+    std::stringstream is;
+    is << R"(
+{
+  "master": {
+    "frame_type": "tcp",
+    "timeout_ms": 4444,
+    "ip_address": "192.168.3.7",
+    "ip_port": 555,
+    )" << socket << R"(
+  }
+}
+)";
+    auto data = nlohmann::json::parse(is);
+    modbus_gateway::TracePath tp;
+    modbus_gateway::TraceDeep td(tp, "master");
+
+    auto master = modbus_gateway::FindObject(td, data);
+
+    EXPECT_ANY_THROW(modbus_gateway::ExtractMaster(td.GetTracePath(), master));
+  }
+}
+
+TEST(ConfigTest, MasterQueueInvalidTest) {
+  for (const std::string queue: {R"("queue_size": 0)", R"("drop_policy": "drop_all")", R"("drop_policy": "earliest_deadline")"}) {
+    std::stringstream is;
+    is << R"(
+{
+  "master": {
+    "frame_type": "tcp",
+    "timeout_ms": 4444,
+    "ip_address": "192.168.3.7",
+    "ip_port": 555,
+    )" << queue << R"(
+  }
+}
+)";
+    auto data = nlohmann::json::parse(is);
+    modbus_gateway::TracePath tp;
+    modbus_gateway::TraceDeep td(tp, "master");
+
+    auto master = modbus_gateway::FindObject(td, data);
+
+    EXPECT_THROW(modbus_gateway::ExtractMaster(td.GetTracePath(), master), modbus_gateway::InvalidValueException);
+  }
+}
+
+TEST(ConfigTest, MasterQueueProfileLimitTest) {
+  std::stringstream is;
+  is << R"(
+{
+  "master": {
+    "frame_type": "tcp",
+    "timeout_ms": 4444,
+    "ip_address": "192.168.3.7",
+    "ip_port": 555,
+    "queue_size": 100000
+  }
+}
+)";
+  auto data = nlohmann::json::parse(is);
+  modbus_gateway::TracePath tp;
+  modbus_gateway::TraceDeep td(tp, "master");
+
+  auto master = modbus_gateway::FindObject(td, data);
+
+  if (modbus_gateway::profile::embedded) {
+    EXPECT_THROW(modbus_gateway::ExtractMaster(td.GetTracePath(), master), modbus_gateway::InvalidValueException);
+  } else {
+    auto tcpMasterConfig = std::dynamic_pointer_cast<modbus_gateway::TcpClientConfig>(
+        modbus_gateway::ExtractMaster(td.GetTracePath(), master));
+    ASSERT_TRUE(tcpMasterConfig);
+    EXPECT_EQ(tcpMasterConfig->queueSize, 100000);
+  }
 }
 
 TEST(ConfigTest, MasterRtuTest) {
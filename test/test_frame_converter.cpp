@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include <common/misc.h>
+
+#include <modbus/modbus_buffer_tcp_wrapper.h>
+
+#include <transport/frame_converter.h>
+
+TEST(FrameConverterTest, SameType) {
+  static const modbus::AduBuffer tcpFrame = {0x0, 0x1, 0x0, 0x0, 0x0, 0x6, 0x1, 0x3, 0x0, 0x0, 0x0, 0x1};
+  auto buffer = test::MakeModbusBuffer(tcpFrame, modbus::FrameType::TCP);
+  const auto origin = buffer;
+
+  EXPECT_FALSE(modbus_gateway::ConvertFrame(buffer, modbus::FrameType::TCP));
+  EXPECT_EQ(buffer.GetType(), modbus::FrameType::TCP);
+  EXPECT_TRUE(test::Compare(buffer, origin));
+}
+
+TEST(FrameConverterTest, TcpToRtu) {
+  static const modbus::AduBuffer tcpFrame = {0x0, 0x1, 0x0, 0x0, 0x0, 0x6, 0x1, 0x3, 0x0, 0x0, 0x0, 0x1};
+  static const modbus::AduBuffer rtuFrame = {0x1, 0x3, 0x0, 0x0, 0x0, 0x1, 0x84, 0x0A};
+  auto buffer = test::MakeModbusBuffer(tcpFrame, modbus::FrameType::TCP);
+
+  EXPECT_TRUE(modbus_gateway::ConvertFrame(buffer, modbus::FrameType::RTU));
+  EXPECT_EQ(buffer.GetType(), modbus::FrameType::RTU);
+  EXPECT_TRUE(test::Compare(buffer, test::MakeModbusBuffer(rtuFrame, modbus::FrameType::RTU)));
+
+  // frame of rtu type is not rebuilt
+  EXPECT_FALSE(modbus_gateway::ConvertFrame(buffer, modbus::FrameType::RTU));
+
+  EXPECT_TRUE(modbus_gateway::ConvertFrame(buffer, modbus::FrameType::TCP));
+  modbus::ModbusBufferTcpWrapper wrapper(buffer);
+  wrapper.SetTransactionId(1);
+  EXPECT_TRUE(test::Compare(buffer, test::MakeModbusBuffer(tcpFrame, modbus::FrameType::TCP)));
+}
+
+TEST(FrameConverterTest, CheckFrame) {
+  static const modbus::AduBuffer rtuFrame = {0x1, 0x3, 0x0, 0x0, 0x0, 0x1, 0x84, 0x0A};
+  static const modbus::AduBuffer badCrcFrame = {0x1, 0x3, 0x0, 0x0, 0x0, 0x1, 0x84, 0x0B};
+  auto buffer = test::MakeModbusBuffer(rtuFrame, modbus::FrameType::RTU);
+  EXPECT_EQ(modbus_gateway::CheckFrame<modbus::FrameType::RTU>(buffer), modbus::CheckFrameResult::NoError);
+
+  auto badBuffer = test::MakeModbusBuffer(badCrcFrame, modbus::FrameType::RTU);
+  EXPECT_NE(modbus_gateway::CheckFrame<modbus::FrameType::RTU>(badBuffer), modbus::CheckFrameResult::NoError);
+}
+
+TEST(FrameConverterTest, RtuToAscii) {
+  static const modbus::AduBuffer rtuFrame = {0x1, 0x3, 0x0, 0x0, 0x0, 0x1, 0x84, 0x0A};
+  auto buffer = test::MakeModbusBuffer(rtuFrame, modbus::FrameType::RTU);
+
+  EXPECT_TRUE(modbus_gateway::ConvertFrame<modbus::FrameType::ASCII>(buffer));
+  EXPECT_EQ(buffer.GetType(), modbus::FrameType::ASCII);
+  EXPECT_EQ(modbus_gateway::CheckFrame<modbus::FrameType::ASCII>(buffer), modbus::CheckFrameResult::NoError);
+
+  EXPECT_TRUE(modbus_gateway::ConvertFrame<modbus::FrameType::RTU>(buffer));
+  EXPECT_TRUE(test::Compare(buffer, test::MakeModbusBuffer(rtuFrame, modbus::FrameType::RTU)));
+}
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include <common/handler_memory.h>
+#include <common/types_asio.h>
+
+#include <chrono>
+#include <memory>
+
+TEST(HandlerMemoryTest, ReuseBlock) {
+  modbus_gateway::HandlerMemory memory;
+  void *first = memory.Allocate(64);
+  // block is in use, concurrent allocation goes to heap
+  void *second = memory.Allocate(64);
+  EXPECT_NE(first, second);
+  memory.Deallocate(second);
+  memory.Deallocate(first);
+
+  void *third = memory.Allocate(64);
+  EXPECT_EQ(first, third);
+  memory.Deallocate(third);
+}
+
+TEST(HandlerMemoryTest, TooBig) {
+  modbus_gateway::HandlerMemory memory;
+  void *big = memory.Allocate(modbus_gateway::HandlerMemory::size + 1);
+  void *small = memory.Allocate(64);
+  EXPECT_NE(big, small);
+  memory.Deallocate(big);
+  memory.Deallocate(small);
+
+  // block was released
+  void *next = memory.Allocate(64);
+  EXPECT_EQ(small, next);
+  memory.Deallocate(next);
+}
+
+TEST(HandlerMemoryTest, AsyncOperationUsesBlock) {
+  asio::io_context context;
+  auto memory = std::make_shared<modbus_gateway::HandlerMemory>();
+
+  void *block = memory->Allocate(64);
+  memory->Deallocate(block);
+
+  asio::steady_timer timer(context);
+  bool called = false;
+  timer.expires_after(std::chrono::milliseconds(1));
+  timer.async_wait(modbus_gateway::MakeAllocHandler(memory, [&called](asio::error_code ec) {
+    EXPECT_FALSE(ec);
+    called = true;
+  }));
+
+  // pending operation holds block
+  void *pending = memory->Allocate(64);
+  EXPECT_NE(pending, block);
+  memory->Deallocate(pending);
+
+  context.run();
+  EXPECT_TRUE(called);
+
+  // block is released before handler call
+  void *after = memory->Allocate(64);
+  EXPECT_EQ(after, block);
+  memory->Deallocate(after);
+}
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include <transport/inflight_table.h>
+
+#include <chrono>
+#include <thread>
+
+namespace {
+
+constexpr auto timeout = std::chrono::milliseconds(10000);
+
+}// namespace
+
+TEST(InflightTableTest, OutOfOrder) {
+  modbus_gateway::InflightTable inflight(3, timeout);
+
+  EXPECT_TRUE(inflight.Insert(1));
+  EXPECT_TRUE(inflight.Insert(2));
+  EXPECT_TRUE(inflight.Insert(3));
+  EXPECT_FALSE(inflight.Insert(4));
+  EXPECT_EQ(inflight.Size(), 3);
+
+  // responses come in any order
+  EXPECT_TRUE(inflight.Erase(2));
+  EXPECT_FALSE(inflight.Erase(2));
+  EXPECT_TRUE(inflight.Erase(3));
+  EXPECT_TRUE(inflight.Erase(1));
+  EXPECT_EQ(inflight.Size(), 0);
+}
+
+TEST(InflightTableTest, SameTransactionId) {
+  modbus_gateway::InflightTable inflight(3, timeout);
+
+  EXPECT_TRUE(inflight.Insert(1));
+  EXPECT_FALSE(inflight.Insert(1));
+  EXPECT_EQ(inflight.Size(), 1);
+}
+
+TEST(InflightTableTest, SlotIsKeptUntilResponse) {
+  modbus_gateway::InflightTable inflight(2, timeout);
+
+  // master completed requests, responses are not sent yet
+  EXPECT_TRUE(inflight.Insert(1));
+  EXPECT_TRUE(inflight.Insert(2));
+  EXPECT_FALSE(inflight.Insert(3));
+  EXPECT_FALSE(inflight.Insert(2));
+
+  EXPECT_TRUE(inflight.Erase(2));
+  EXPECT_TRUE(inflight.Insert(3));
+  EXPECT_TRUE(inflight.Erase(1));
+  EXPECT_TRUE(inflight.Erase(3));
+}
+
+TEST(InflightTableTest, ExpiredRequest) {
+  modbus_gateway::InflightTable inflight(2, std::chrono::milliseconds(5));
+
+  EXPECT_TRUE(inflight.Insert(1));
+  EXPECT_TRUE(inflight.Insert(2));
+  EXPECT_FALSE(inflight.Insert(3));
+
+  // requests are not answered in time, their slots are free
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_TRUE(inflight.Insert(2));
+  EXPECT_TRUE(inflight.Insert(3));
+  EXPECT_EQ(inflight.Size(), 2);
+  EXPECT_FALSE(inflight.Erase(1));
+  EXPECT_TRUE(inflight.Erase(2));
+  EXPECT_TRUE(inflight.Erase(3));
+}
@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+
+#include <common/inline_callback.h>
+#include <common/timer_wheel.h>
+
+#include <memory>
+
+TEST(InlineCallbackTest, Invoke) {
+  int calls = 0;
+  modbus_gateway::InlineCallback<32> callback([&calls]() {
+    ++calls;
+  });
+  ASSERT_TRUE(callback);
+  callback();
+  callback();
+  EXPECT_EQ(calls, 2);
+
+  callback = nullptr;
+  EXPECT_FALSE(callback);
+}
+
+TEST(InlineCallbackTest, MoveKeepsState) {
+  auto state = std::make_shared<int>(0);
+  modbus_gateway::InlineCallback<32> first([state]() {
+    ++*state;
+  });
+  EXPECT_EQ(state.use_count(), 2);
+
+  modbus_gateway::InlineCallback<32> second(std::move(first));
+  EXPECT_FALSE(first);
+  EXPECT_EQ(state.use_count(), 2);
+  second();
+  EXPECT_EQ(*state, 1);
+
+  // captured state is released with callback
+  second = nullptr;
+  EXPECT_EQ(state.use_count(), 1);
+}
+
+TEST(InlineCallbackTest, DeadlineOfQueuedRequestFits) {
+  // weak reference to exchange and shared request, as request queue arms it
+  std::weak_ptr<int> weak;
+  std::shared_ptr<int> shared;
+  auto callback = [weak, shared]() {};
+  EXPECT_LE(sizeof(callback), modbus_gateway::TimerWheel::Callback::size);
+}
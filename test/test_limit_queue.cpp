@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include <common/limit_queue.h>
+
+#include <vector>
+
+namespace {
+
+std::vector<int> ToVector(const modbus_gateway::LimitQueue<int> &queue) {
+  std::vector<int> values;
+  for (size_t pos = 0; pos < queue.Size(); ++pos) {
+    values.push_back(queue.At(pos));
+  }
+  return values;
+}
+
+}// namespace
+
+TEST(LimitQueueTest, PushPop) {
+  modbus_gateway::LimitQueue<int> queue(3);
+  EXPECT_EQ(queue.Capacity(), 3);
+  EXPECT_TRUE(queue.Empty());
+
+  EXPECT_TRUE(queue.Push(1));
+  EXPECT_TRUE(queue.Push(2));
+  EXPECT_TRUE(queue.Push(3));
+  EXPECT_TRUE(queue.Full());
+  EXPECT_FALSE(queue.Push(4));
+  EXPECT_EQ(queue.Size(), 3);
+
+  // head goes around end of storage
+  for (int value = 1; value <= 10; ++value) {
+    EXPECT_EQ(queue.Front(), value);
+    queue.Pop();
+    EXPECT_TRUE(queue.Push(value + 3));
+  }
+  EXPECT_EQ(ToVector(queue), (std::vector<int>{11, 12, 13}));
+}
+
+TEST(LimitQueueTest, Erase) {
+  modbus_gateway::LimitQueue<int> queue(5);
+  for (int value = 0; value < 7; ++value) {
+    queue.Push(value);
+    if (queue.Full()) {
+      queue.Pop();
+    }
+  }
+  EXPECT_EQ(ToVector(queue), (std::vector<int>{3, 4, 5, 6}));
+
+  queue.Erase(1);
+  EXPECT_EQ(ToVector(queue), (std::vector<int>{3, 5, 6}));
+  queue.Erase(2);
+  EXPECT_EQ(ToVector(queue), (std::vector<int>{3, 5}));
+  queue.Erase(0);
+  EXPECT_EQ(ToVector(queue), (std::vector<int>{5}));
+  queue.Erase(0);
+  EXPECT_TRUE(queue.Empty());
+
+  EXPECT_TRUE(queue.Push(7));
+  EXPECT_EQ(queue.Front(), 7);
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <transport/mbap_reassembler.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+using Adu = std::vector<uint8_t>;
+
+const Adu firstAdu = {0x0, 0x1, 0x0, 0x0, 0x0, 0x3, 0x1, 0x3, 0x4};
+const Adu secondAdu = {0x0, 0x2, 0x0, 0x0, 0x0, 0x6, 0x1, 0x3, 0x0, 0x0, 0x0, 0x2};
+
+// Copy bytes to ring as socket does, space may be split by end of ring
+void Receive(modbus_gateway::MbapReassembler &reassembler, const Adu &bytes) {
+  size_t offset = 0;
+  while (offset < bytes.size()) {
+    const auto buffer = reassembler.Prepare();
+    const size_t size = std::min(buffer.size(), bytes.size() - offset);
+    ASSERT_GT(size, 0);
+    std::memcpy(buffer.data(), bytes.data() + offset, size);
+    reassembler.Commit(size);
+    offset += size;
+  }
+}
+
+Adu Take(modbus_gateway::MbapReassembler &reassembler) {
+  size_t aduSize = 0;
+  if (modbus_gateway::MbapReassembler::Result::Complete != reassembler.Next(aduSize)) {
+    return {};
+  }
+  Adu adu(aduSize);
+  reassembler.Take(adu.data(), aduSize);
+  return adu;
+}
+
+}// namespace
+
+TEST(MbapReassemblerTest, SeveralAduInSegment) {
+  modbus_gateway::MbapReassembler reassembler(modbus_gateway::MbapReassembler::maxAduSize);
+  Adu segment = firstAdu;
+  segment.insert(segment.end(), secondAdu.begin(), secondAdu.end());
+  Receive(reassembler, segment);
+
+  EXPECT_EQ(Take(reassembler), firstAdu);
+  EXPECT_EQ(Take(reassembler), secondAdu);
+  size_t aduSize = 0;
+  EXPECT_EQ(reassembler.Next(aduSize), modbus_gateway::MbapReassembler::Result::NeedMore);
+  EXPECT_EQ(reassembler.Size(), 0);
+}
+
+TEST(MbapReassemblerTest, SplitAdu) {
+  modbus_gateway::MbapReassembler reassembler(modbus_gateway::MbapReassembler::maxAduSize);
+  size_t aduSize = 0;
+
+  // header is not complete
+  Receive(reassembler, Adu(secondAdu.begin(), secondAdu.begin() + 4));
+  EXPECT_EQ(reassembler.Next(aduSize), modbus_gateway::MbapReassembler::Result::NeedMore);
+  // body is not complete
+  Receive(reassembler, Adu(secondAdu.begin() + 4, secondAdu.begin() + 9));
+  EXPECT_EQ(reassembler.Next(aduSize), modbus_gateway::MbapReassembler::Result::NeedMore);
+
+  Receive(reassembler, Adu(secondAdu.begin() + 9, secondAdu.end()));
+  EXPECT_EQ(Take(reassembler), secondAdu);
+}
+
+TEST(MbapReassemblerTest, WrapAround) {
+  modbus_gateway::MbapReassembler reassembler(modbus_gateway::MbapReassembler::maxAduSize);
+  // adu goes around end of ring many times
+  for (size_t i = 0; i < 100; ++i) {
+    Receive(reassembler, secondAdu);
+    Receive(reassembler, firstAdu);
+    EXPECT_EQ(Take(reassembler), secondAdu);
+    EXPECT_EQ(Take(reassembler), firstAdu);
+  }
+}
+
+TEST(MbapReassemblerTest, Invalid) {
+  modbus_gateway::MbapReassembler reassembler(modbus_gateway::MbapReassembler::maxAduSize);
+  size_t aduSize = 0;
+
+  // protocol id is not modbus
+  Receive(reassembler, {0x0, 0x1, 0x0, 0x1, 0x0, 0x3, 0x1, 0x3, 0x4});
+  EXPECT_EQ(reassembler.Next(aduSize), modbus_gateway::MbapReassembler::Result::Invalid);
+  reassembler.Reset();
+
+  // length is longer than max adu
+  Receive(reassembler, {0x0, 0x1, 0x0, 0x0, 0x1, 0x0, 0x1, 0x3, 0x4});
+  EXPECT_EQ(reassembler.Next(aduSize), modbus_gateway::MbapReassembler::Result::Invalid);
+  reassembler.Reset();
+
+  // pdu is empty
+  Receive(reassembler, {0x0, 0x1, 0x0, 0x0, 0x0, 0x1, 0x1});
+  EXPECT_EQ(reassembler.Next(aduSize), modbus_gateway::MbapReassembler::Result::Invalid);
+  reassembler.Reset();
+
+  Receive(reassembler, firstAdu);
+  EXPECT_EQ(Take(reassembler), firstAdu);
+}
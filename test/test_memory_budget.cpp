@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+
+#include <common/memory_budget.h>
+
+#include <utility>
+
+TEST(MemoryBudgetTest, Limit) {
+  auto budget = std::make_shared<modbus_gateway::MemoryBudget>(100);
+  EXPECT_TRUE(budget->TryCharge(60));
+  EXPECT_FALSE(budget->TryCharge(50));
+  EXPECT_TRUE(budget->TryCharge(40));
+  EXPECT_EQ(budget->Used(), 100);
+
+  budget->Release(60);
+  EXPECT_EQ(budget->Used(), 40);
+  EXPECT_TRUE(budget->TryCharge(50));
+}
+
+TEST(MemoryBudgetTest, Parent) {
+  auto global = std::make_shared<modbus_gateway::MemoryBudget>(100);
+  auto first = std::make_shared<modbus_gateway::MemoryBudget>(70, global);
+  auto second = std::make_shared<modbus_gateway::MemoryBudget>(70, global);
+
+  EXPECT_TRUE(first->TryCharge(70));
+  EXPECT_FALSE(first->TryCharge(1));
+  // global budget is exhausted by first connection, second connection keeps own budget
+  EXPECT_FALSE(second->TryCharge(40));
+  EXPECT_EQ(second->Used(), 0);
+  EXPECT_TRUE(second->TryCharge(30));
+  EXPECT_EQ(global->Used(), 100);
+
+  first->Release(70);
+  EXPECT_EQ(global->Used(), 30);
+}
+
+TEST(MemoryBudgetTest, Charge) {
+  auto global = std::make_shared<modbus_gateway::MemoryBudget>(100);
+  auto budget = std::make_shared<modbus_gateway::MemoryBudget>(modbus_gateway::MemoryBudget::unlimited, global);
+  {
+    auto charge = modbus_gateway::MemoryCharge::TryMake(budget, 80);
+    ASSERT_TRUE(charge);
+    EXPECT_EQ(charge.Bytes(), 80);
+    EXPECT_FALSE(modbus_gateway::MemoryCharge::TryMake(budget, 80));
+
+    // charge is moved with message, bytes are returned once
+    modbus_gateway::MemoryCharge moved = std::move(charge);
+    EXPECT_TRUE(moved);
+    EXPECT_EQ(budget->Used(), 80);
+  }
+  EXPECT_EQ(budget->Used(), 0);
+  EXPECT_EQ(global->Used(), 0);
+
+  EXPECT_FALSE(modbus_gateway::MemoryCharge::TryMake(nullptr, 1));
+}
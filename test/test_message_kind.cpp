@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+
+#include <message/client_disconnect_message.h>
+#include <message/message_kind.h>
+#include <message/modbus_message.h>
+
+namespace {
+
+class OtherMessage : public exchange::IMessage {};
+
+}// namespace
+
+TEST(MessageKindTest, GetMessageKind) {
+  const auto modbusMessage = modbus_gateway::MakeModbusMessage(modbus_gateway::ModbusMessageInfo(1, 2), nullptr);
+  EXPECT_EQ(modbus_gateway::GetMessageKind(*modbusMessage), modbus_gateway::MessageKind::Modbus);
+
+  const auto clientDisconnect = modbus_gateway::ClientDisconnectMessage::Create(1);
+  EXPECT_EQ(modbus_gateway::GetMessageKind(*clientDisconnect), modbus_gateway::MessageKind::ClientDisconnect);
+
+  const OtherMessage other;
+  EXPECT_EQ(modbus_gateway::GetMessageKind(other), modbus_gateway::MessageKind::Unknown);
+}
+
+TEST(MessageKindTest, MessageCast) {
+  const exchange::MessagePtr modbusMessage = modbus_gateway::MakeModbusMessage(modbus_gateway::ModbusMessageInfo(1, 2), nullptr);
+  const exchange::MessagePtr clientDisconnect = modbus_gateway::ClientDisconnectMessage::Create(1);
+
+  const auto modbus = modbus_gateway::MessageCast<modbus_gateway::ModbusMessage>(modbusMessage);
+  ASSERT_TRUE(modbus);
+  EXPECT_EQ(modbus->GetModbusMessageInfo().GetTransactionId(), 2);
+  EXPECT_FALSE(modbus_gateway::MessageCast<modbus_gateway::ClientDisconnectMessage>(modbusMessage));
+
+  const auto disconnect = modbus_gateway::MessageCast<modbus_gateway::ClientDisconnectMessage>(clientDisconnect);
+  ASSERT_TRUE(disconnect);
+  EXPECT_EQ(disconnect->GetClientId(), 1);
+  EXPECT_FALSE(modbus_gateway::MessageCast<modbus_gateway::ModbusMessage>(clientDisconnect));
+
+  EXPECT_FALSE(modbus_gateway::MessageCast<modbus_gateway::ModbusMessage>(nullptr));
+}
@@ -0,0 +1,28 @@
+#include <gtest/gtest.h>
+
+#include <common/misc.h>
+
+#include <transport/modbus_exception.h>
+
+TEST(ModbusExceptionTest, TcpRequest) {
+  static const modbus::AduBuffer request = {0x0, 0x7, 0x0, 0x0, 0x0, 0x6, 0x1, 0x3, 0x0, 0x0, 0x0, 0x1};
+  static const modbus::AduBuffer response = {0x0, 0x7, 0x0, 0x0, 0x0, 0x3, 0x1, 0x83, 0x6};
+  auto buffer = test::MakeModbusBuffer(request, modbus::FrameType::TCP);
+
+  modbus_gateway::MakeExceptionResponse(buffer, modbus_gateway::ModbusExceptionCode::ServerDeviceBusy);
+  EXPECT_EQ(buffer.GetType(), modbus::FrameType::TCP);
+  EXPECT_TRUE(test::Compare(buffer, test::MakeModbusBuffer(response, modbus::FrameType::TCP)));
+}
+
+TEST(ModbusExceptionTest, RtuRequest) {
+  static const modbus::AduBuffer request = {0x1, 0x3, 0x0, 0x0, 0x0, 0x1, 0x84, 0x0A};
+  auto buffer = test::MakeModbusBuffer(request, modbus::FrameType::RTU);
+
+  modbus_gateway::MakeExceptionResponse(buffer, modbus_gateway::ModbusExceptionCode::GatewayTargetFailed);
+  // response is tcp frame, slave converts it to own frame type
+  ASSERT_EQ(buffer.GetType(), modbus::FrameType::TCP);
+  ASSERT_EQ(buffer.GetAduSize(), 9);
+  EXPECT_EQ(buffer.begin()[6], 0x1);
+  EXPECT_EQ(buffer.begin()[7], 0x83);
+  EXPECT_EQ(buffer.begin()[8], 0x0B);
+}
@@ -23,7 +23,9 @@ protected:
     modbusMessageSender = test::ModbusMessageSender::Create(exchange);
     const exchange::ActorId modbusMessageSenderId = exchange->Add(modbusMessageSender);
 
-    modbusRtuMaster = modbus_gateway::ModbusRtuMaster::Create(exchange, context, deviceIn, modbus_gateway::RtuOptions{}, messageTimeout, modbus::RTU);
+    timerWheel = std::make_shared<modbus_gateway::TimerWheel>(context, std::chrono::milliseconds(1), 64);
+
+    modbusRtuMaster = modbus_gateway::ModbusRtuMaster::Create(exchange, context, timerWheel, deviceIn, modbus_gateway::RtuOptions{}, messageTimeout);
     modbusRtuMasterId = exchange->Add(modbusRtuMaster);
 
     testModbusRtuSlave = std::make_unique<test::TestModbusRtuSlave>(context, deviceOut, modbus::RTU);
@@ -55,6 +57,7 @@ protected:
 
   test::ContextRunner contextRunner = test::ContextRunner{1};
   exchange::ExchangePtr exchange = nullptr;
+  modbus_gateway::TimerWheelPtr timerWheel = nullptr;
   test::ModbusMessageSender::Ptr modbusMessageSender = nullptr;
   modbus_gateway::ModbusRtuMaster::Ptr modbusRtuMaster = nullptr;
   exchange::ActorId modbusRtuMasterId = 0;
@@ -85,7 +88,12 @@ TEST_F(ModbusRtuMasterTest, TimeoutTest) {
       return nullptr;
     },
                                 sendBuffer);
-    ASSERT_FALSE(answer);
+    // request without response is answered with gateway target failed, exception is tcp frame
+    ASSERT_TRUE(answer);
+    ASSERT_TRUE(answer->GetModbusBuffer());
+    ASSERT_EQ(answer->GetModbusBuffer()->GetAduSize(), 9);
+    EXPECT_EQ(answer->GetModbusBuffer()->begin()[7], 0x86);
+    EXPECT_EQ(answer->GetModbusBuffer()->begin()[8], 0x0B);
   }
   {// good
     static const modbus::AduBuffer tcpFrame = {0x1, 0x6, 0xDF, 0x62, 0x38};
@@ -23,7 +23,7 @@ protected:
 
     const exchange::ActorId modbusEchoActorId = exchange->Add(modbusMessageSender);
     modbus_gateway::RouterPtr singleRouter = std::make_shared<test::SingleRouter>(modbusEchoActorId);
-    modbusRtuSlave = modbus_gateway::ModbusRtuSlave::Create(exchange, context, deviceOut, modbus_gateway::RtuOptions{}, singleRouter, modbus::RTU);
+    modbusRtuSlave = modbus_gateway::ModbusRtuSlave::Create(exchange, context, deviceOut, modbus_gateway::RtuOptions{}, singleRouter);
     exchange->Add(modbusRtuSlave);
 
     modbusRtuSlave->Start();
@@ -22,7 +22,10 @@ protected:
     modbusMessageSender = test::ModbusMessageSender::Create(exchange);
     const exchange::ActorId modbusMessageSenderId = exchange->Add(modbusMessageSender);
 
-    modbusRtuMaster = modbus_gateway::ModbusTcpClient::Create(exchange, context, addr, port, messageTimeout);
+    timerWheel = std::make_shared<modbus_gateway::TimerWheel>(context, std::chrono::milliseconds(1), 64);
+
+    modbusRtuMaster = modbus_gateway::ModbusTcpClient::Create(exchange, context, timerWheel, addr, port, messageTimeout,
+                                                              modbus_gateway::SocketOptions{});
     modbusRtuMasterId = exchange->Add(modbusRtuMaster);
 
     testModbusRtuSlave = std::make_unique<test::TestModbusTcpServer>(context, addr, port);
@@ -48,12 +51,13 @@ protected:
   }
 
   const asio::ip::address_v4 addr = asio::ip::address_v4::loopback();
-  const asio::ip::port_type port = 1234;
+  const asio::ip::port_type port = test::FreePort(asio::ip::address(addr));
   static constexpr auto waitExchange = std::chrono::milliseconds(2000);
   static constexpr auto messageTimeout = std::chrono::milliseconds(1000);
 
   test::ContextRunner contextRunner = test::ContextRunner{1};
   exchange::ExchangePtr exchange = nullptr;
+  modbus_gateway::TimerWheelPtr timerWheel = nullptr;
   test::ModbusMessageSender::Ptr modbusMessageSender = nullptr;
   modbus_gateway::ModbusTcpClient::Ptr modbusRtuMaster = nullptr;
   exchange::ActorId modbusRtuMasterId = 0;
@@ -96,7 +100,12 @@ TEST_F(ModbusTcpClientTest, TimeoutTest) {
       return nullptr;
     },
                                 sendBuffer);
-    ASSERT_FALSE(answer);
+    // request without response is answered with gateway target failed
+    ASSERT_TRUE(answer);
+    ASSERT_TRUE(answer->GetModbusBuffer());
+    ASSERT_EQ(answer->GetModbusBuffer()->GetAduSize(), 9);
+    EXPECT_EQ(answer->GetModbusBuffer()->begin()[7], 0x83);
+    EXPECT_EQ(answer->GetModbusBuffer()->begin()[8], 0x0B);
   }
   {// good
     static const modbus::AduBuffer tcpFrame = {0x0, 0x1, 0x0, 0x0, 0x0, 0x3, 0x1, 0x3, 0x4};
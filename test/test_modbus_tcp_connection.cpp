@@ -11,6 +11,8 @@
 
 #include <modbus/modbus_buffer_tcp_wrapper.h>
 
+#include <algorithm>
+#include <atomic>
 #include <thread>
 
 
@@ -27,7 +29,7 @@ protected:
     const exchange::ActorId modbusEchoActorId = exchange->Add(modbusMessageSender);
     modbus_gateway::RouterPtr singleRouter = std::make_shared<test::SingleRouter>(modbusEchoActorId);
     tcpServer = modbus_gateway::ModbusTcpServer::Create(exchange, context, asio::ip::address(addr), port,
-                                                        singleRouter);
+                                                        singleRouter, modbus_gateway::SocketOptions{});
     exchange->Add(tcpServer);
     tcpServer->Start();
 
@@ -52,7 +54,7 @@ protected:
   }
 
   const asio::ip::address_v4 addr = asio::ip::address_v4::loopback();
-  const asio::ip::port_type port = 1234;
+  const asio::ip::port_type port = test::FreePort(asio::ip::address(addr));
   static constexpr auto waitExchange = std::chrono::milliseconds(100);
 
   test::ContextRunner contextRunner = test::ContextRunner{1};
@@ -95,36 +97,127 @@ TEST_F(ModbusTcpConnectionTest, SaveTransactionId) {
   EXPECT_TRUE(test::Compare(*sendBuffer, *receiveBuffer));
 }
 
-TEST_F(ModbusTcpConnectionTest, CheckRequest) {
+TEST_F(ModbusTcpConnectionTest, SplitLargeRequest) {
+  // write multiple registers with 123 registers, body is received by several receives after header
+  modbus::AduBuffer tcpFrame = {0x0, 0x1, 0x0, 0x0, 0x0, 0xFD, 0x1, 0x10, 0x0, 0x0, 0x0, 0x7B, 0xF6};
+  for (size_t i = 0; i < 0xF6; ++i) {
+    tcpFrame.push_back(static_cast<uint8_t>(i));
+  }
   auto receiveBuffer = std::make_shared<modbus::ModbusBuffer>(modbus::FrameType::TCP);
-  size_t messageCount = 0;
+  std::atomic<size_t> messageCount = 0;
+  auto handler = [&messageCount](const modbus_gateway::ModbusMessagePtr &in) -> modbus_gateway::ModbusMessagePtr {
+    ++messageCount;
+    return in;
+  };
+
+  const size_t half = tcpFrame.size() / 2;
+  auto header = std::make_shared<modbus::ModbusBuffer>(
+      test::MakeModbusBuffer({tcpFrame.begin(), tcpFrame.begin() + 7}, modbus::FrameType::TCP));
+  Process(handler, header, receiveBuffer);
+  EXPECT_EQ(messageCount, 0);
+
+  auto firstHalf = std::make_shared<modbus::ModbusBuffer>(
+      test::MakeModbusBuffer({tcpFrame.begin() + 7, tcpFrame.begin() + half}, modbus::FrameType::TCP));
+  Process(handler, firstHalf, receiveBuffer);
+  EXPECT_EQ(messageCount, 0);
+
+  auto secondHalf = std::make_shared<modbus::ModbusBuffer>(
+      test::MakeModbusBuffer({tcpFrame.begin() + half, tcpFrame.end()}, modbus::FrameType::TCP));
+  Process(handler, secondHalf, receiveBuffer);
+  EXPECT_EQ(messageCount, 1);
+
+  auto sendBuffer = std::make_shared<modbus::ModbusBuffer>(
+      test::MakeModbusBuffer(tcpFrame, modbus::FrameType::TCP));
+  EXPECT_TRUE(test::Compare(*sendBuffer, *receiveBuffer));
+}
 
+TEST_F(ModbusTcpConnectionTest, InvalidHeader) {
+  static const modbus::AduBuffer validFrame = {0x0, 0x2, 0x0, 0x0, 0x0, 0x3, 0x1, 0x3, 0x4};
+  auto receiveBuffer = std::make_shared<modbus::ModbusBuffer>(modbus::FrameType::TCP);
+  std::atomic<size_t> messageCount = 0;
   auto handler = [&messageCount](const modbus_gateway::ModbusMessagePtr &in) -> modbus_gateway::ModbusMessagePtr {
     ++messageCount;
     return in;
   };
 
-  {// invalid size for tcp
-    static const modbus::AduBuffer tcpFrame = {0x3, 0x1, 0x3, 0x4};
-    auto sendBuffer = std::make_shared<modbus::ModbusBuffer>(
-        test::MakeModbusBuffer(tcpFrame, modbus::FrameType::RTU));
-    Process(handler, sendBuffer, receiveBuffer);
+  // stream is out of sync, connection is closed and next request is not served
+  auto check = [&](const modbus::AduBuffer &invalidFrame) {
+    messageCount = 0;
+    Process(handler, std::make_shared<modbus::ModbusBuffer>(test::MakeModbusBuffer(invalidFrame, modbus::FrameType::TCP)),
+            receiveBuffer);
+    Process(handler, std::make_shared<modbus::ModbusBuffer>(test::MakeModbusBuffer(validFrame, modbus::FrameType::TCP)),
+            receiveBuffer);
     EXPECT_EQ(messageCount, 0);
+    testConnection->Disconnect();
+    ASSERT_FALSE(testConnection->Connect());
+  };
+
+  {// protocol id is not modbus
+    check({0x0, 0x1, 0x0, 0x1, 0x0, 0x3, 0x1, 0x3, 0x4});
   }
 
-  {// invalid type for tcp
-    static const modbus::AduBuffer tcpFrame = {0x10, 0x0, 0x0, 0x0, 0x1, 0x2, 0x0, 0x0};
-    auto sendBuffer = std::make_shared<modbus::ModbusBuffer>(
-        test::MakeModbusBuffer(tcpFrame, modbus::FrameType::RTU));
-    Process(handler, sendBuffer, receiveBuffer);
-    EXPECT_EQ(messageCount, 0);
+  {// length is over max adu
+    check({0x10, 0x0, 0x0, 0x0, 0x1, 0x2, 0x0, 0x0});
   }
+
+  // new connection is served
+  Process(handler, std::make_shared<modbus::ModbusBuffer>(test::MakeModbusBuffer(validFrame, modbus::FrameType::TCP)),
+          receiveBuffer);
+  EXPECT_EQ(messageCount, 1);
 }
 
-TEST_F(ModbusTcpConnectionTest, CheckResponse) {
+TEST_F(ModbusTcpConnectionTest, PipelinedRequests) {
+  // two requests in one segment
+  static const modbus::AduBuffer tcpFrames = {0x0, 0x1, 0x0, 0x0, 0x0, 0x3, 0x1, 0x3, 0x4,
+                                              0x0, 0x2, 0x0, 0x0, 0x0, 0x3, 0x1, 0x3, 0x5};
+  auto sendBuffer = std::make_shared<modbus::ModbusBuffer>(
+      test::MakeModbusBuffer(tcpFrames, modbus::FrameType::TCP));
+  auto receiveBuffer = std::make_shared<modbus::ModbusBuffer>(modbus::FrameType::TCP);
+  std::atomic<size_t> messageCount = 0;
+
+  Process([&messageCount](const modbus_gateway::ModbusMessagePtr &in) -> modbus_gateway::ModbusMessagePtr {
+    ++messageCount;
+    return in;
+  },
+          sendBuffer, receiveBuffer);
+
+  EXPECT_EQ(messageCount, 2);
+  // both requests are in flight, responses follow each other
+  ASSERT_GE(receiveBuffer->GetAduSize(), tcpFrames.size() / 2);
+  EXPECT_TRUE(std::equal(receiveBuffer->begin(), receiveBuffer->begin() + tcpFrames.size() / 2, tcpFrames.begin()));
+}
+
+TEST_F(ModbusTcpConnectionTest, SplitRequest) {
   static const modbus::AduBuffer tcpFrame = {0x0, 0x1, 0x0, 0x0, 0x0, 0x3, 0x1, 0x3, 0x4};
+  auto receiveBuffer = std::make_shared<modbus::ModbusBuffer>(modbus::FrameType::TCP);
+  std::atomic<size_t> messageCount = 0;
+  auto handler = [&messageCount](const modbus_gateway::ModbusMessagePtr &in) -> modbus_gateway::ModbusMessagePtr {
+    ++messageCount;
+    return in;
+  };
+
+  // header is split, request is routed when last part is received
+  auto firstPart = std::make_shared<modbus::ModbusBuffer>(
+      test::MakeModbusBuffer({tcpFrame.begin(), tcpFrame.begin() + 4}, modbus::FrameType::TCP));
+  Process(handler, firstPart, receiveBuffer);
+  EXPECT_EQ(messageCount, 0);
+
+  auto secondPart = std::make_shared<modbus::ModbusBuffer>(
+      test::MakeModbusBuffer({tcpFrame.begin() + 4, tcpFrame.end()}, modbus::FrameType::TCP));
+  Process(handler, secondPart, receiveBuffer);
+  EXPECT_EQ(messageCount, 1);
+
   auto sendBuffer = std::make_shared<modbus::ModbusBuffer>(
       test::MakeModbusBuffer(tcpFrame, modbus::FrameType::TCP));
+  EXPECT_TRUE(test::Compare(*sendBuffer, *receiveBuffer));
+}
+
+TEST_F(ModbusTcpConnectionTest, CheckResponse) {
+  // request which is not answered holds its transaction id until inflight timeout, every case uses own id
+  auto makeRequest = [](uint8_t transactionId) {
+    const modbus::AduBuffer tcpFrame = {0x0, transactionId, 0x0, 0x0, 0x0, 0x3, 0x1, 0x3, 0x4};
+    return std::make_shared<modbus::ModbusBuffer>(test::MakeModbusBuffer(tcpFrame, modbus::FrameType::TCP));
+  };
   auto receiveBuffer = std::make_shared<modbus::ModbusBuffer>(modbus::FrameType::TCP);
   auto defaultSize = receiveBuffer->GetAduSize();
 
@@ -135,7 +228,7 @@ TEST_F(ModbusTcpConnectionTest, CheckResponse) {
       auto response = modbus_gateway::ModbusMessage::Create(messageInfo, in->GetModbusBuffer());
       return response;
     },
-            sendBuffer, receiveBuffer);
+            makeRequest(0x1), receiveBuffer);
 
     EXPECT_EQ(defaultSize, receiveBuffer->GetAduSize());
   }
@@ -146,7 +239,7 @@ TEST_F(ModbusTcpConnectionTest, CheckResponse) {
       auto response = modbus_gateway::ModbusMessage::Create(messageInfo, in->GetModbusBuffer());
       return response;
     },
-            sendBuffer, receiveBuffer);
+            makeRequest(0x3), receiveBuffer);
 
     EXPECT_EQ(defaultSize, receiveBuffer->GetAduSize());
   }
@@ -155,7 +248,7 @@ TEST_F(ModbusTcpConnectionTest, CheckResponse) {
       auto response = modbus_gateway::ModbusMessage::Create(in->GetModbusMessageInfo(), nullptr);
       return response;
     },
-            sendBuffer, receiveBuffer);
+            makeRequest(0x5), receiveBuffer);
 
     EXPECT_EQ(defaultSize, receiveBuffer->GetAduSize());
   }
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <common/context_runner.h>
+#include <common/misc.h>
+#include <common/modbus_message_actor.h>
+#include <common/single_router.h>
+#include <common/test_modbus_tcp_client.h>
+
+#include <transport/modbus_tcp_server.h>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+struct ModbusTcpServerTest : testing::Test {
+protected:
+  void SetUp() override {
+    contextRunner.Run();
+    exchange = test::MakeExchange();
+    auto echoActor = test::ModbusMessageActor::Create(exchange);
+    const exchange::ActorId echoActorId = exchange->Add(echoActor);
+    router = std::make_shared<test::SingleRouter>(echoActorId);
+  }
+
+  void TearDown() override {
+    for (auto &client : clients) {
+      client->Disconnect();
+    }
+    if (tcpServer) {
+      tcpServer->Stop();
+    }
+    contextRunner.Stop();
+  }
+
+  void StartServer(const modbus_gateway::ConnectionLimits &connectionLimits) {
+    tcpServer = modbus_gateway::ModbusTcpServer::Create(exchange, contextRunner.GetContext(),
+                                                        asio::ip::address(addr), port, router,
+                                                        modbus_gateway::SocketOptions{});
+    tcpServer->SetConnectionLimits(connectionLimits);
+    exchange->Add(tcpServer);
+    tcpServer->Start();
+  }
+
+  void Connect() {
+    clients.push_back(std::make_unique<test::TestModbusTcpClient>(contextRunner.GetContext(),
+                                                                  asio::ip::address(addr), port));
+    ASSERT_FALSE(clients.back()->Connect());
+    std::this_thread::sleep_for(waitAccept);
+  }
+
+  const asio::ip::address_v4 addr = asio::ip::address_v4::loopback();
+  const asio::ip::port_type port = test::FreePort(asio::ip::address(addr));
+  static constexpr auto waitAccept = std::chrono::milliseconds(50);
+
+  test::ContextRunner contextRunner = test::ContextRunner{1};
+  exchange::ExchangePtr exchange = nullptr;
+  modbus_gateway::RouterPtr router = nullptr;
+  modbus_gateway::ModbusTcpServer::Ptr tcpServer = nullptr;
+  std::vector<std::unique_ptr<test::TestModbusTcpClient>> clients;
+};
+
+TEST_F(ModbusTcpServerTest, MaxConnectionsPerIp) {
+  modbus_gateway::ConnectionLimits connectionLimits;
+  connectionLimits.maxConnectionsPerIp = 1;
+  StartServer(connectionLimits);
+
+  Connect();
+  Connect();
+
+  const auto stats = tcpServer->GetConnectionStats();
+  EXPECT_EQ(stats.accepted, 1);
+  EXPECT_EQ(stats.rejected, 1);
+}
+
+TEST_F(ModbusTcpServerTest, IdleTimeout) {
+  modbus_gateway::ConnectionLimits connectionLimits;
+  connectionLimits.idleTimeout = std::chrono::milliseconds(50);
+  StartServer(connectionLimits);
+
+  Connect();
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+  const auto stats = tcpServer->GetConnectionStats();
+  EXPECT_EQ(stats.accepted, 1);
+  EXPECT_EQ(stats.reaped, 1);
+}
+
+TEST_F(ModbusTcpServerTest, EvictIdle) {
+  modbus_gateway::ConnectionLimits connectionLimits;
+  connectionLimits.maxConnections = 1;
+  connectionLimits.evictIdle = true;
+  StartServer(connectionLimits);
+
+  Connect();
+  Connect();
+
+  const auto stats = tcpServer->GetConnectionStats();
+  EXPECT_EQ(stats.accepted, 2);
+  EXPECT_EQ(stats.rejected, 0);
+  EXPECT_EQ(stats.evicted, 1);
+}
+
+TEST_F(ModbusTcpServerTest, DisconnectFreesConnection) {
+  modbus_gateway::ConnectionLimits connectionLimits;
+  connectionLimits.maxConnections = 1;
+  StartServer(connectionLimits);
+
+  Connect();
+  // disconnect message is handled on server strand
+  clients.back()->Disconnect();
+  std::this_thread::sleep_for(waitAccept);
+  Connect();
+
+  const auto stats = tcpServer->GetConnectionStats();
+  EXPECT_EQ(stats.accepted, 2);
+  EXPECT_EQ(stats.rejected, 0);
+}
+
+TEST_F(ModbusTcpServerTest, DisconnectFreesConnectionPerIp) {
+  modbus_gateway::ConnectionLimits connectionLimits;
+  connectionLimits.maxConnectionsPerIp = 1;
+  StartServer(connectionLimits);
+
+  Connect();
+  clients.back()->Disconnect();
+  std::this_thread::sleep_for(waitAccept);
+  Connect();
+
+  const auto stats = tcpServer->GetConnectionStats();
+  EXPECT_EQ(stats.accepted, 2);
+  EXPECT_EQ(stats.rejected, 0);
+}
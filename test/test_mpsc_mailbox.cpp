@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <common/mpsc_mailbox.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST(MpscMailboxTest, PushPop) {
+  modbus_gateway::MpscMailbox<int> mailbox(3);
+  EXPECT_EQ(mailbox.Capacity(), 4);
+
+  bool wake = false;
+  EXPECT_TRUE(mailbox.Push(1, wake));
+  EXPECT_TRUE(wake);
+  EXPECT_TRUE(mailbox.Push(2, wake));
+  EXPECT_FALSE(wake);
+  EXPECT_TRUE(mailbox.Push(3, wake));
+  EXPECT_TRUE(mailbox.Push(4, wake));
+  EXPECT_FALSE(mailbox.Push(5, wake));
+  EXPECT_EQ(mailbox.Size(), 4);
+
+  int value = 0;
+  for (int expect = 1; expect <= 4; ++expect) {
+    ASSERT_TRUE(mailbox.Pop(value));
+    EXPECT_EQ(value, expect);
+    EXPECT_EQ(mailbox.Release(), expect != 4);
+  }
+  EXPECT_FALSE(mailbox.Pop(value));
+
+  EXPECT_TRUE(mailbox.Push(6, wake));
+  EXPECT_TRUE(wake);
+  ASSERT_TRUE(mailbox.Pop(value));
+  EXPECT_EQ(value, 6);
+  EXPECT_FALSE(mailbox.Release());
+}
+
+TEST(MpscMailboxTest, ManyProducers) {
+  static constexpr size_t producers = 4;
+  static constexpr size_t perProducer = 10000;
+  modbus_gateway::MpscMailbox<size_t> mailbox(64);
+
+  std::atomic<size_t> wakes(0);
+  std::vector<std::thread> threads;
+  for (size_t producer = 0; producer < producers; ++producer) {
+    threads.emplace_back([&mailbox, &wakes]() {
+      for (size_t i = 0; i < perProducer; ++i) {
+        bool wake = false;
+        while (!mailbox.Push(i + 1, wake)) {
+          std::this_thread::yield();
+        }
+        if (wake) {
+          ++wakes;
+        }
+      }
+    });
+  }
+
+  size_t received = 0;
+  size_t sum = 0;
+  size_t value = 0;
+  while (received < producers * perProducer) {
+    if (!mailbox.Pop(value)) {
+      std::this_thread::yield();
+      continue;
+    }
+    sum += value;
+    ++received;
+    mailbox.Release();
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(sum, producers * perProducer * (perProducer + 1) / 2);
+  EXPECT_EQ(mailbox.Size(), 0);
+  EXPECT_GE(wakes, 1);
+}
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <common/pool_allocator.h>
+#include <common/types_modbus.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct TestTag {};
+
+struct Object {
+  explicit Object(int value)
+      : value(value) {}
+
+  int value;
+  char payload[100]{};
+};
+
+using TestAllocator = modbus_gateway::PoolAllocator<Object, TestTag, 4>;
+
+}// namespace
+
+TEST(PoolAllocatorTest, ReuseReleasedBlock) {
+  const auto before = modbus_gateway::PoolCounters<TestTag>::Get();
+
+  auto first = std::allocate_shared<Object>(TestAllocator(), 1);
+  const void *address = first.get();
+  first.reset();
+
+  auto second = std::allocate_shared<Object>(TestAllocator(), 2);
+  EXPECT_EQ(second.get(), address);
+  EXPECT_EQ(second->value, 2);
+
+  const auto after = modbus_gateway::PoolCounters<TestTag>::Get();
+  EXPECT_EQ(after.misses - before.misses, 1);
+  EXPECT_EQ(after.hits - before.hits, 1);
+}
+
+TEST(PoolAllocatorTest, CacheLimit) {
+  std::vector<std::shared_ptr<Object>> objects;
+  for (int i = 0; i < 10; ++i) {
+    objects.push_back(std::allocate_shared<Object>(TestAllocator(), i));
+  }
+  // only 4 blocks are kept in cache, others are returned to heap
+  objects.clear();
+
+  const auto before = modbus_gateway::PoolCounters<TestTag>::Get();
+  for (int i = 0; i < 10; ++i) {
+    objects.push_back(std::allocate_shared<Object>(TestAllocator(), i));
+  }
+  const auto after = modbus_gateway::PoolCounters<TestTag>::Get();
+  EXPECT_EQ(after.hits - before.hits, 4);
+  EXPECT_EQ(after.misses - before.misses, 6);
+}
+
+TEST(PoolAllocatorTest, ReleaseOnOtherThread) {
+  static constexpr int count = 8;
+  std::vector<std::shared_ptr<Object>> objects;
+  for (int i = 0; i < count; ++i) {
+    objects.push_back(std::allocate_shared<Object>(TestAllocator(), i));
+  }
+  std::thread thread([objects = std::move(objects)]() mutable {
+    // blocks go back to cache of allocating thread
+    objects.clear();
+  });
+  thread.join();
+
+  const auto before = modbus_gateway::PoolCounters<TestTag>::Get();
+  for (int i = 0; i < count; ++i) {
+    objects.push_back(std::allocate_shared<Object>(TestAllocator(), i));
+  }
+  const auto after = modbus_gateway::PoolCounters<TestTag>::Get();
+  EXPECT_EQ(after.hits - before.hits, count);
+  EXPECT_EQ(after.misses - before.misses, 0);
+}
+
+TEST(PoolAllocatorTest, OwnerThreadFinished) {
+  std::shared_ptr<Object> object;
+  std::thread thread([&object]() {
+    object = std::allocate_shared<Object>(TestAllocator(), 1);
+  });
+  thread.join();
+  // owner cache is closed, block goes to heap
+  EXPECT_EQ(object->value, 1);
+  object.reset();
+  SUCCEED();
+}
+
+TEST(PoolAllocatorTest, CrossThreadSteadyState) {
+  // producer allocates and consumer releases, as network and master threads do
+  static constexpr int rounds = 1000;
+  static constexpr int batch = 16;
+  std::vector<std::shared_ptr<Object>> objects;
+  const auto roundTrip = [&]() {
+    for (int i = 0; i < batch; ++i) {
+      objects.push_back(std::allocate_shared<Object>(TestAllocator(), i));
+    }
+    std::thread release([objects = std::move(objects)]() mutable {
+      objects.clear();
+    });
+    release.join();
+    objects.clear();
+  };
+  // warm up
+  roundTrip();
+
+  const auto before = modbus_gateway::PoolCounters<TestTag>::Get();
+  for (int round = 0; round < rounds; ++round) {
+    roundTrip();
+  }
+  const auto after = modbus_gateway::PoolCounters<TestTag>::Get();
+  EXPECT_EQ(after.hits - before.hits, rounds * batch);
+  EXPECT_EQ(after.misses - before.misses, 0);
+}
+
+TEST(PoolAllocatorTest, ModbusBuffer) {
+  const auto before = modbus_gateway::GetModbusBufferPoolStats();
+  for (int i = 0; i < 10; ++i) {
+    auto buffer = modbus_gateway::MakeModbusBuffer(modbus::FrameType::TCP);
+    EXPECT_EQ(buffer->GetType(), modbus::FrameType::TCP);
+  }
+  const auto after = modbus_gateway::GetModbusBufferPoolStats();
+  EXPECT_EQ(after.hits + after.misses - before.hits - before.misses, 10);
+  EXPECT_GE(after.hits - before.hits, 9);
+}
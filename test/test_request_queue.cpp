@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <common/misc.h>
+#include <common/modbus_message_sender.h>
+
+#include <transport/request_queue.h>
+
+#include <chrono>
+#include <thread>
+
+struct RequestQueueTest : testing::Test {
+protected:
+  void TearDown() override {
+    timerWheel->Stop();
+  }
+
+  // Request of source, next request is created later
+  static modbus_gateway::ModbusMessagePtr MakeRequest(exchange::ActorId sourceId) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return modbus_gateway::MakeModbusMessage(modbus_gateway::ModbusMessageInfo(sourceId, 1),
+                                             modbus_gateway::MakeModbusBuffer(modbus::FrameType::TCP));
+  }
+
+  static constexpr auto timeout = std::chrono::milliseconds(10000);
+  static constexpr size_t capacity = 2;
+
+  exchange::ExchangePtr exchange = test::MakeExchange();
+  modbus_gateway::ContextPtr context = std::make_shared<modbus_gateway::ContextPtr::element_type>();
+  modbus_gateway::TimerWheelPtr timerWheel =
+      std::make_shared<modbus_gateway::TimerWheel>(context, std::chrono::milliseconds(1), 16);
+};
+
+TEST_F(RequestQueueTest, DropOldest) {
+  modbus_gateway::RequestQueue queue(exchange, timerWheel, timeout, capacity, modbus_gateway::DropPolicy::DropOldest);
+  const auto first = MakeRequest(1);
+  const auto second = MakeRequest(2);
+  const auto third = MakeRequest(3);
+
+  EXPECT_FALSE(queue.Push(first));
+  EXPECT_FALSE(queue.Push(second));
+  EXPECT_EQ(queue.Push(third), first);
+  EXPECT_EQ(queue.Size(), capacity);
+  // deadline of dropped request is canceled
+  EXPECT_EQ(timerWheel->Size(), capacity);
+
+  modbus_gateway::ModbusMessagePtr message;
+  ASSERT_TRUE(queue.Pop(message));
+  EXPECT_EQ(message, second);
+  ASSERT_TRUE(queue.Pop(message));
+  EXPECT_EQ(message, third);
+  EXPECT_FALSE(queue.Pop(message));
+  EXPECT_FALSE(message);
+}
+
+TEST_F(RequestQueueTest, RejectNewest) {
+  modbus_gateway::RequestQueue queue(exchange, timerWheel, timeout, capacity, modbus_gateway::DropPolicy::RejectNewest);
+  const auto first = MakeRequest(1);
+  const auto second = MakeRequest(2);
+  const auto third = MakeRequest(3);
+
+  EXPECT_FALSE(queue.Push(first));
+  EXPECT_FALSE(queue.Push(second));
+  EXPECT_EQ(queue.Push(third), third);
+  EXPECT_EQ(timerWheel->Size(), capacity);
+
+  modbus_gateway::ModbusMessagePtr message;
+  ASSERT_TRUE(queue.Pop(message));
+  EXPECT_EQ(message, first);
+  ASSERT_TRUE(queue.Pop(message));
+  EXPECT_EQ(message, second);
+}
+
+TEST_F(RequestQueueTest, ExpiredPlace) {
+  modbus_gateway::RequestQueue queue(exchange, timerWheel, std::chrono::milliseconds(5), capacity,
+                                     modbus_gateway::DropPolicy::RejectNewest);
+  EXPECT_FALSE(queue.Push(MakeRequest(1)));
+  EXPECT_FALSE(queue.Push(MakeRequest(2)));
+
+  // deadline timers release queued requests
+  context->run_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(timerWheel->Size(), 0);
+
+  const auto next = MakeRequest(3);
+  EXPECT_FALSE(queue.Push(next));
+  EXPECT_EQ(queue.Size(), 1);
+}
+
+TEST_F(RequestQueueTest, ExpiredAnswered) {
+  static const modbus::AduBuffer request = {0x0, 0x7, 0x0, 0x0, 0x0, 0x6, 0x1, 0x3, 0x0, 0x0, 0x0, 0x1};
+  static const modbus::AduBuffer response = {0x0, 0x7, 0x0, 0x0, 0x0, 0x3, 0x1, 0x83, 0xB};
+  auto source = std::make_shared<test::ModbusMessageSender>(exchange);
+  const auto sourceId = exchange->Add(source);
+
+  modbus_gateway::RequestQueue queue(exchange, timerWheel, std::chrono::milliseconds(5), capacity,
+                                     modbus_gateway::DropPolicy::RejectNewest);
+  auto modbusBuffer = std::make_shared<modbus::ModbusBuffer>(test::MakeModbusBuffer(request, modbus::FrameType::TCP));
+  EXPECT_FALSE(queue.Push(modbus_gateway::MakeModbusMessage(modbus_gateway::ModbusMessageInfo(sourceId, 7), modbusBuffer)));
+
+  // source gets "gateway target failed" instead of silence
+  context->run_for(std::chrono::milliseconds(100));
+  ASSERT_EQ(source->receiveCount, 1);
+  EXPECT_TRUE(test::Compare(*source->receiveMessage->GetModbusBuffer(),
+                            test::MakeModbusBuffer(response, modbus::FrameType::TCP)));
+
+  modbus_gateway::ModbusMessagePtr message;
+  EXPECT_FALSE(queue.Pop(message));
+  exchange->Delete(sourceId);
+}
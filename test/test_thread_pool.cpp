@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <common/thread_pool.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+TEST(ThreadPoolTest, RunOnAllThreads) {
+  static constexpr size_t threads = 4;
+  auto context = std::make_shared<modbus_gateway::ContextPtr::element_type>(static_cast<int>(threads));
+  auto work = asio::executor_work_guard(context->get_executor());
+  modbus_gateway::ThreadPool threadPool(context, threads);
+  threadPool.Run();
+
+  std::mutex m;
+  std::condition_variable cv;
+  size_t waiting = 0;
+  std::set<std::thread::id> ids;
+
+  // every task block thread until all tasks started, it possible only with parallel execution
+  for (size_t i = 0; i < threads; ++i) {
+    asio::post(*context, [&]() {
+      std::unique_lock<std::mutex> lock(m);
+      ids.insert(std::this_thread::get_id());
+      ++waiting;
+      cv.notify_all();
+      cv.wait_for(lock, std::chrono::seconds(5), [&]() { return waiting == threads; });
+    });
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(m);
+    EXPECT_TRUE(cv.wait_for(lock, std::chrono::seconds(5), [&]() { return waiting == threads; }));
+  }
+
+  work.reset();
+  threadPool.Stop();
+  EXPECT_NO_THROW(threadPool.Join());
+  EXPECT_EQ(ids.size(), threads);
+}
+
+TEST(ThreadPoolTest, ExceptionFromHandler) {
+  auto context = std::make_shared<modbus_gateway::ContextPtr::element_type>(2);
+  auto work = asio::executor_work_guard(context->get_executor());
+  modbus_gateway::ThreadPool threadPool(context, 2);
+  threadPool.Run();
+
+  asio::post(*context, []() {
+    throw std::runtime_error("handler error");
+  });
+
+  EXPECT_THROW(threadPool.Join(), std::runtime_error);
+}
+
+TEST(ThreadPoolTest, BusyPoll) {
+  auto context = std::make_shared<modbus_gateway::ContextPtr::element_type>(1);
+  auto work = asio::executor_work_guard(context->get_executor());
+  modbus_gateway::ThreadPool threadPool(context, 1);
+  modbus_gateway::ThreadOptions threadOptions;
+  threadOptions.busyPoll = true;
+  threadPool.SetThreadOptions(threadOptions);
+  threadPool.Run();
+
+  std::atomic<size_t> executed(0);
+  asio::steady_timer timer(*context, std::chrono::milliseconds(10));
+  timer.async_wait([&executed](const asio::error_code &ec) {
+    if (!ec) {
+      ++executed;
+    }
+  });
+  asio::post(*context, [&executed]() {
+    ++executed;
+  });
+
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (executed < 2 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  work.reset();
+  threadPool.Stop();
+  EXPECT_NO_THROW(threadPool.Join());
+  EXPECT_EQ(executed, 2);
+}
+
+TEST(ThreadPoolTest, StartHandler) {
+  static constexpr size_t threads = 3;
+  auto context = std::make_shared<modbus_gateway::ContextPtr::element_type>(static_cast<int>(threads));
+  modbus_gateway::ThreadPool threadPool(context, threads);
+
+  std::mutex m;
+  std::set<std::thread::id> ids;
+  threadPool.SetStartHandler([&]() {
+    std::scoped_lock<std::mutex> lock(m);
+    ids.insert(std::this_thread::get_id());
+  });
+
+  // context without work returns immediately, start handler is called anyway
+  threadPool.Run();
+  EXPECT_NO_THROW(threadPool.Join());
+  EXPECT_EQ(ids.size(), threads);
+}
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include <common/thread_pool.h>
+#include <common/timer_wheel.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+struct TimerWheelTest : testing::Test {
+protected:
+  void SetUp() override {
+    timerWheel = std::make_shared<modbus_gateway::TimerWheel>(context, tick, slots);
+    threadPool.Run();
+  }
+
+  void TearDown() override {
+    timerWheel->Stop();
+    work.reset();
+    threadPool.Stop();
+    threadPool.Join();
+  }
+
+  static constexpr auto tick = std::chrono::milliseconds(1);
+  static constexpr size_t slots = 16;
+
+  modbus_gateway::ContextPtr context = std::make_shared<modbus_gateway::ContextPtr::element_type>();
+  asio::executor_work_guard<modbus_gateway::ContextPtr::element_type::executor_type> work =
+      asio::make_work_guard(*context);
+  modbus_gateway::ThreadPool threadPool = modbus_gateway::ThreadPool(context, 1);
+  modbus_gateway::TimerWheelPtr timerWheel = nullptr;
+};
+
+TEST_F(TimerWheelTest, Expire) {
+  std::atomic<bool> expired = false;
+  const auto begin = std::chrono::steady_clock::now();
+  std::atomic<std::chrono::steady_clock::duration> elapsed{};
+  auto handle = timerWheel->Arm(std::chrono::milliseconds(20), [&]() {
+    elapsed = std::chrono::steady_clock::now() - begin;
+    expired = true;
+  });
+  EXPECT_EQ(timerWheel->Size(), 1);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  EXPECT_TRUE(expired);
+  EXPECT_GE(elapsed.load(), std::chrono::milliseconds(20));
+  EXPECT_EQ(timerWheel->Size(), 0);
+  EXPECT_FALSE(timerWheel->Cancel(handle));
+}
+
+TEST_F(TimerWheelTest, Cancel) {
+  std::atomic<bool> expired = false;
+  auto handle = timerWheel->Arm(std::chrono::milliseconds(20), [&]() {
+    expired = true;
+  });
+  EXPECT_TRUE(timerWheel->Cancel(handle));
+  EXPECT_FALSE(timerWheel->Cancel(handle));
+  EXPECT_EQ(timerWheel->Size(), 0);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_FALSE(expired);
+}
+
+TEST_F(TimerWheelTest, LongerThanRevolution) {
+  // timeout is several wheel revolutions
+  std::atomic<size_t> expired = 0;
+  timerWheel->Arm(tick * slots * 3, [&]() {
+    ++expired;
+  });
+  timerWheel->Arm(tick * 2, [&]() {
+    ++expired;
+  });
+
+  std::this_thread::sleep_for(tick * slots);
+  EXPECT_EQ(expired, 1);
+  std::this_thread::sleep_for(tick * slots * 4);
+  EXPECT_EQ(expired, 2);
+}
+
+TEST_F(TimerWheelTest, StaleHandle) {
+  auto first = timerWheel->Arm(std::chrono::milliseconds(50), []() {});
+  auto copy = first;
+  EXPECT_TRUE(timerWheel->Cancel(first));
+
+  // node is reused by next timer, old handle must not cancel it
+  auto second = timerWheel->Arm(std::chrono::milliseconds(50), []() {});
+  EXPECT_FALSE(timerWheel->Cancel(copy));
+  EXPECT_EQ(timerWheel->Size(), 1);
+  EXPECT_TRUE(timerWheel->Cancel(second));
+}
+
+TEST_F(TimerWheelTest, Many) {
+  static constexpr size_t count = 1000;
+  std::atomic<size_t> expired = 0;
+  std::vector<modbus_gateway::TimerWheel::Handle> handles;
+  for (size_t i = 0; i < count; ++i) {
+    handles.push_back(timerWheel->Arm(std::chrono::milliseconds(10 + i % 50), [&]() {
+      ++expired;
+    }));
+  }
+  // cancel every second timer
+  for (size_t i = 0; i < count; i += 2) {
+    EXPECT_TRUE(timerWheel->Cancel(handles[i]));
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  EXPECT_EQ(expired, count / 2);
+  EXPECT_EQ(timerWheel->Size(), 0);
+}
+
+TEST_F(TimerWheelTest, EarlierDeadline) {
+  // wheel sleeps until long deadline, shorter one armed later wakes it earlier
+  std::atomic<bool> longExpired = false;
+  std::atomic<bool> shortExpired = false;
+  timerWheel->Arm(std::chrono::milliseconds(500), [&]() {
+    longExpired = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  timerWheel->Arm(std::chrono::milliseconds(20), [&]() {
+    shortExpired = true;
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(150));
+  EXPECT_TRUE(shortExpired);
+  EXPECT_FALSE(longExpired);
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  EXPECT_TRUE(longExpired);
+}
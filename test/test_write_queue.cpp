@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <transport/write_queue.h>
+
+#include <iterator>
+
+namespace {
+
+modbus_gateway::ModbusBufferPtr MakeResponse() {
+  return modbus_gateway::MakeModbusBuffer(modbus::FrameType::TCP);
+}
+
+size_t Count(const modbus_gateway::WriteQueue::Buffers &buffers) {
+  return static_cast<size_t>(std::distance(buffers.begin(), buffers.end()));
+}
+
+}// namespace
+
+TEST(WriteQueueTest, GatherReady) {
+  modbus_gateway::WriteQueue writeQueue(8, 8);
+  const auto first = MakeResponse();
+
+  // idle queue, caller starts write
+  EXPECT_TRUE(writeQueue.Push(first));
+  auto buffers = writeQueue.StartBatch();
+  ASSERT_EQ(Count(buffers), 1);
+  EXPECT_EQ(buffers.begin()->data(), first->begin().operator->());
+  EXPECT_EQ(buffers.begin()->size(), first->GetAduSize());
+
+  // write is outstanding, responses wait
+  EXPECT_FALSE(writeQueue.Push(MakeResponse()));
+  EXPECT_FALSE(writeQueue.Push(MakeResponse()));
+  EXPECT_FALSE(writeQueue.Push(MakeResponse()));
+
+  ASSERT_TRUE(writeQueue.CompleteBatch());
+  EXPECT_EQ(Count(writeQueue.StartBatch()), 3);
+  EXPECT_EQ(writeQueue.BatchSize(), 3);
+  EXPECT_FALSE(writeQueue.CompleteBatch());
+
+  EXPECT_TRUE(writeQueue.Push(MakeResponse()));
+}
+
+TEST(WriteQueueTest, MaxBatch) {
+  modbus_gateway::WriteQueue writeQueue(1, 8);
+  EXPECT_TRUE(writeQueue.Push(MakeResponse()));
+  EXPECT_FALSE(writeQueue.Push(MakeResponse()));
+
+  EXPECT_EQ(Count(writeQueue.StartBatch()), 1);
+  ASSERT_TRUE(writeQueue.CompleteBatch());
+  EXPECT_EQ(Count(writeQueue.StartBatch()), 1);
+  EXPECT_FALSE(writeQueue.CompleteBatch());
+}
+
+TEST(WriteQueueTest, Reset) {
+  modbus_gateway::WriteQueue writeQueue(8, 8);
+  EXPECT_TRUE(writeQueue.Push(MakeResponse()));
+  writeQueue.StartBatch();
+  EXPECT_FALSE(writeQueue.Push(MakeResponse()));
+
+  // write error drops responses
+  writeQueue.Reset();
+  EXPECT_EQ(writeQueue.BatchSize(), 0);
+  EXPECT_TRUE(writeQueue.Push(MakeResponse()));
+}
+
+TEST(WriteQueueTest, Capacity) {
+  modbus_gateway::WriteQueue writeQueue(8, 2);
+  EXPECT_TRUE(writeQueue.Push(MakeResponse()));
+  writeQueue.StartBatch();
+
+  // batch in write is not counted
+  EXPECT_FALSE(writeQueue.Full());
+  EXPECT_FALSE(writeQueue.Push(MakeResponse()));
+  EXPECT_FALSE(writeQueue.Full());
+  EXPECT_FALSE(writeQueue.Push(MakeResponse()));
+  EXPECT_TRUE(writeQueue.Full());
+  EXPECT_EQ(writeQueue.Size(), 2);
+
+  // response of taken request is queued over capacity
+  EXPECT_FALSE(writeQueue.Push(MakeResponse()));
+  EXPECT_EQ(writeQueue.Size(), 3);
+
+  ASSERT_TRUE(writeQueue.CompleteBatch());
+  EXPECT_EQ(Count(writeQueue.StartBatch()), 3);
+  EXPECT_FALSE(writeQueue.Full());
+  EXPECT_EQ(writeQueue.Size(), 0);
+}